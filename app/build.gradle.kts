@@ -13,8 +13,8 @@ android {
         applicationId = "com.komarudude.materialbench"
         minSdk = 30
         targetSdk = 36
-        versionCode = 20
-        versionName = "1.2.0-beta7"
+        versionCode = 21
+        versionName = "1.2.0-beta8"
 
         testInstrumentationRunner = "androidx.test.runner.AndroidJUnitRunner"
 
@@ -0,0 +1,185 @@
+#include <jni.h>
+#include <android/asset_manager.h>
+#include <android/imagedecoder.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <sys/resource.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "utils.h"
+
+// Native preprocessing for the LiteRT benchmark: the JPEG assets are decoded in parallel with
+// AImageDecoder into RGBA, then each image is normalized ((x / 255 - mean) / std, NHWC RGB floats)
+// straight into the caller's reusable FloatArray. Decode and normalization are timed separately
+// from inference.
+
+static const int AI_INPUT_WIDTH = 384;
+static const int AI_INPUT_HEIGHT = 384;
+static const float AI_MEAN[3] = {0.485f, 0.456f, 0.406f};
+static const float AI_STD[3] = {0.229f, 0.224f, 0.225f};
+
+static std::vector<std::vector<uint8_t>> g_ai_images;   // RGBA, AI_INPUT_WIDTH * AI_INPUT_HEIGHT * 4 each
+static std::mutex g_ai_images_mutex;
+
+static bool decode_asset_rgba(AAssetManager* manager, const std::string& path, std::vector<uint8_t>& out) {
+    AAsset* asset = AAssetManager_open(manager, path.c_str(), AASSET_MODE_BUFFER);
+    if (!asset) return false;
+
+    AImageDecoder* decoder = nullptr;
+    if (AImageDecoder_createFromAAsset(asset, &decoder) != ANDROID_IMAGE_DECODER_SUCCESS) {
+        AAsset_close(asset);
+        return false;
+    }
+
+    bool ok = false;
+    const AImageDecoderHeaderInfo* info = AImageDecoder_getHeaderInfo(decoder);
+    if (AImageDecoderHeaderInfo_getWidth(info) == AI_INPUT_WIDTH && AImageDecoderHeaderInfo_getHeight(info) == AI_INPUT_HEIGHT &&
+        AImageDecoder_setAndroidBitmapFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888) == ANDROID_IMAGE_DECODER_SUCCESS) {
+        const size_t stride = AI_INPUT_WIDTH * 4;
+        out.resize(stride * AI_INPUT_HEIGHT);
+        ok = AImageDecoder_getMinimumStride(decoder) <= stride &&
+             AImageDecoder_decodeImage(decoder, out.data(), stride, out.size()) == ANDROID_IMAGE_DECODER_SUCCESS;
+    } else {
+        LOGE("AI preprocess: %s is not %dx%d", path.c_str(), AI_INPUT_WIDTH, AI_INPUT_HEIGHT);
+    }
+
+    AImageDecoder_delete(decoder);
+    AAsset_close(asset);
+    return ok;
+}
+
+// RGBA -> normalized RGB floats, out = x * scale[c] + bias[c]
+static void normalize_rgba_to_rgb_float(const uint8_t* rgba, float* out, size_t pixels) {
+    float scale[3], bias[3];
+    for (int c = 0; c < 3; ++c) {
+        scale[c] = 1.0f / (255.0f * AI_STD[c]);
+        bias[c] = -AI_MEAN[c] / AI_STD[c];
+    }
+
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t scale_r = vdupq_n_f32(scale[0]), bias_r = vdupq_n_f32(bias[0]);
+    const float32x4_t scale_g = vdupq_n_f32(scale[1]), bias_g = vdupq_n_f32(bias[1]);
+    const float32x4_t scale_b = vdupq_n_f32(scale[2]), bias_b = vdupq_n_f32(bias[2]);
+
+    // 16 pixels per iteration: de-interleave RGBA, widen to float, fused multiply-add, re-interleave as RGB
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t px = vld4q_u8(rgba + i * 4);
+        uint16x8_t r16[2] = {vmovl_u8(vget_low_u8(px.val[0])), vmovl_u8(vget_high_u8(px.val[0]))};
+        uint16x8_t g16[2] = {vmovl_u8(vget_low_u8(px.val[1])), vmovl_u8(vget_high_u8(px.val[1]))};
+        uint16x8_t b16[2] = {vmovl_u8(vget_low_u8(px.val[2])), vmovl_u8(vget_high_u8(px.val[2]))};
+
+        for (int half = 0; half < 2; ++half) {
+            for (int quarter = 0; quarter < 2; ++quarter) {
+                uint16x4_t r4 = quarter ? vget_high_u16(r16[half]) : vget_low_u16(r16[half]);
+                uint16x4_t g4 = quarter ? vget_high_u16(g16[half]) : vget_low_u16(g16[half]);
+                uint16x4_t b4 = quarter ? vget_high_u16(b16[half]) : vget_low_u16(b16[half]);
+
+                float32x4x3_t rgb;
+                rgb.val[0] = vfmaq_f32(bias_r, vcvtq_f32_u32(vmovl_u16(r4)), scale_r);
+                rgb.val[1] = vfmaq_f32(bias_g, vcvtq_f32_u32(vmovl_u16(g4)), scale_g);
+                rgb.val[2] = vfmaq_f32(bias_b, vcvtq_f32_u32(vmovl_u16(b4)), scale_b);
+                vst3q_f32(out + (i + half * 8 + quarter * 4) * 3, rgb);
+            }
+        }
+    }
+#endif
+    for (; i < pixels; ++i) {
+        out[i * 3 + 0] = rgba[i * 4 + 0] * scale[0] + bias[0];
+        out[i * 3 + 1] = rgba[i * 4 + 1] * scale[1] + bias[1];
+        out[i * 3 + 2] = rgba[i * 4 + 2] * scale[2] + bias[2];
+    }
+}
+
+extern "C" {
+
+// Decodes the given asset paths on every performance core. Returns the wall time in ms, negative on error.
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeAiDecodeImages(
+        JNIEnv* env, jobject /*thiz*/, jobject activity, jobjectArray paths) {
+
+    AAssetManager* manager = get_asset_manager(env, activity);
+    if (!manager) return -1;
+
+    const jsize count = env->GetArrayLength(paths);
+    std::vector<std::string> path_list(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto path = (jstring)env->GetObjectArrayElement(paths, i);
+        const char* chars = env->GetStringUTFChars(path, nullptr);
+        path_list[i] = chars;
+        env->ReleaseStringUTFChars(path, chars);
+        env->DeleteLocalRef(path);
+    }
+
+    std::lock_guard<std::mutex> lock(g_ai_images_mutex);
+    g_ai_images.assign(count, std::vector<uint8_t>());
+
+    std::vector<int> cores = get_performance_cores();
+    std::atomic<jsize> next_image{0};
+    std::atomic<bool> error_flag{false};
+    std::vector<std::thread> threads;
+    threads.reserve(cores.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int core : cores) {
+        threads.emplace_back([&, core]() {
+            pin_to_core(core);
+            setpriority(PRIO_PROCESS, 0, -10);
+            while (!error_flag.load(std::memory_order_relaxed)) {
+                jsize i = next_image.fetch_add(1, std::memory_order_relaxed);
+                if (i >= count) break;
+                if (!decode_asset_rgba(manager, path_list[i], g_ai_images[i])) {
+                    LOGE("AI preprocess: failed to decode %s", path_list[i].c_str());
+                    error_flag = true;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (error_flag) {
+        g_ai_images.clear();
+        return -1;
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    LOGI("AI preprocess: decoded %d images on %zu core(s) in %lld ms", count, cores.size(), (long long)ms);
+    return ms;
+}
+
+// Normalizes decoded image `index` into output (384*384*3 floats). Returns the kernel time in ns, negative on error.
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeAiNormalizeImage(
+        JNIEnv* env, jobject /*thiz*/, jint index, jfloatArray output) {
+
+    const size_t pixels = static_cast<size_t>(AI_INPUT_WIDTH) * AI_INPUT_HEIGHT;
+    if (env->GetArrayLength(output) != static_cast<jsize>(pixels * 3)) return -1;
+
+    std::lock_guard<std::mutex> lock(g_ai_images_mutex);
+    if (index < 0 || index >= static_cast<jint>(g_ai_images.size()) || g_ai_images[index].size() != pixels * 4) return -1;
+
+    auto* out = static_cast<float*>(env->GetPrimitiveArrayCritical(output, nullptr));
+    if (!out) return -1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    normalize_rgba_to_rgb_float(g_ai_images[index].data(), out, pixels);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    env->ReleasePrimitiveArrayCritical(output, out, 0);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeAiReleaseImages(
+        JNIEnv* /*env*/, jobject /*thiz*/) {
+    std::lock_guard<std::mutex> lock(g_ai_images_mutex);
+    std::vector<std::vector<uint8_t>>().swap(g_ai_images);
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A workload of the mixed contention benchmark, implemented next to the engine it reuses.
+// prepare() does the untimed setup (buffers, files, pipelines) once; run() then works on the given
+// cores until stop is set and returns the units it finished. run() is called once per phase.
+class ContentionLoad {
+public:
+    virtual ~ContentionLoad() = default;
+
+    virtual const char* name() const = 0;
+    virtual const char* unit() const = 0;   // of run() per second, used in metric names
+    virtual int max_cores() const = 0;
+    virtual bool prepare() = 0;             // false if the subsystem is unavailable
+    virtual double run(const std::vector<int>& cores, const std::atomic<bool>& stop) = 0;
+};
+
+std::unique_ptr<ContentionLoad> make_cpu_math_load();                       // cpu_math.cpp
+std::unique_ptr<ContentionLoad> make_ram_bandwidth_load();                  // ram_sweep.cpp
+std::unique_ptr<ContentionLoad> make_rom_random_load(const std::string& dir);  // rom_random.cpp
+std::unique_ptr<ContentionLoad> make_gpu_gemm_load();                       // vulkan_compute.cpp
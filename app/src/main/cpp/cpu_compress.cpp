@@ -0,0 +1,238 @@
+#include <jni.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sys/resource.h>
+#include "utils.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
+
+// Deflate (zlib) compression and decompression on a reproducible mixed-entropy corpus.
+// The corpus is cut into independent blocks (like pigz) that a pool of threads compresses
+// and then decompresses; the same pipeline runs on one core or on every performance core.
+
+static const size_t COMPRESS_BLOCK_SIZE = 256 * 1024;
+static const size_t COMPRESS_TEXT_BYTES = 6 * 1024 * 1024;
+static const size_t COMPRESS_RECORD_BYTES = 5 * 1024 * 1024;
+static const size_t COMPRESS_RANDOM_BYTES = 1024 * 1024;
+static const int COMPRESS_LEVELS[] = {1, 6, 9};
+static const int COMPRESS_PASSES = 3;
+
+struct CompressBlock {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uLong crc = 0;
+    std::vector<uint8_t> compressed;
+    uLongf compressed_size = 0;
+};
+
+// text: sentences built from the ImageNet class names; then the raw class list, the JPEG assets,
+// little-endian sensor-style records and a slice of incompressible random bytes
+static std::vector<uint8_t> build_compress_corpus(AAssetManager* assets) {
+    std::vector<uint8_t> corpus;
+    std::mt19937 gen(0xC0FFEEu);
+
+    std::vector<uint8_t> classes;
+    if (!read_asset(assets, "imagenet_classes.txt", classes)) {
+        LOGW("Compression corpus: imagenet_classes.txt not found");
+        const char fallback[] = "tench goldfish great white shark tiger shark hammerhead electric ray stingray";
+        classes.assign(fallback, fallback + sizeof(fallback) - 1);
+    }
+
+    std::vector<std::string> words;
+    std::string word;
+    for (uint8_t c : classes) {
+        if (isalpha(c)) {
+            word += static_cast<char>(tolower(c));
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty()) words.push_back(word);
+
+    std::uniform_int_distribution<size_t> pick_word(0, words.size() - 1);
+    std::uniform_int_distribution<int> sentence_len(4, 18);
+    while (corpus.size() < COMPRESS_TEXT_BYTES) {
+        int n = sentence_len(gen);
+        for (int i = 0; i < n; ++i) {
+            const std::string& w = words[pick_word(gen)];
+            corpus.insert(corpus.end(), w.begin(), w.end());
+            corpus.push_back(i + 1 == n ? '.' : ' ');
+        }
+        corpus.push_back(gen() % 8 == 0 ? '\n' : ' ');
+    }
+
+    corpus.insert(corpus.end(), classes.begin(), classes.end());
+
+    std::vector<uint8_t> image;
+    for (int i = 1; i <= 100; ++i) {
+        if (read_asset(assets, "images/" + std::to_string(i) + ".jpg", image)) {
+            corpus.insert(corpus.end(), image.begin(), image.end());
+        }
+    }
+
+    struct Record { uint32_t id; uint32_t timestamp; int16_t values[6]; uint32_t flags; };
+    Record r{};
+    std::normal_distribution<float> noise(0.0f, 40.0f);
+    for (size_t produced = 0; produced < COMPRESS_RECORD_BYTES; produced += sizeof(Record)) {
+        r.id++;
+        r.timestamp += 20 + gen() % 3;
+        for (auto& v : r.values) v = static_cast<int16_t>(v + static_cast<int16_t>(noise(gen)));
+        r.flags = (gen() % 16 == 0) ? static_cast<uint32_t>(gen()) : r.flags;
+        auto bytes = reinterpret_cast<const uint8_t*>(&r);
+        corpus.insert(corpus.end(), bytes, bytes + sizeof(Record));
+    }
+
+    for (size_t i = 0; i < COMPRESS_RANDOM_BYTES; ++i) corpus.push_back(static_cast<uint8_t>(gen()));
+    return corpus;
+}
+
+// Runs fn(worker_index, block_index) for every block on the given cores, each worker claiming blocks from a shared counter
+template <class Fn>
+static bool run_block_pipeline(const std::vector<int>& cores, size_t block_count, Fn fn) {
+    std::atomic<size_t> next_block{0};
+    std::atomic<bool> error_flag{false};
+    EnergyRegion energy;
+    PerfRegion perf;
+    std::vector<std::thread> threads;
+    threads.reserve(cores.size());
+    for (size_t w = 0; w < cores.size(); ++w) {
+        threads.emplace_back([&, w]() {
+            pin_to_core(cores[w]);
+            setpriority(PRIO_PROCESS, 0, -10);
+            while (!error_flag.load(std::memory_order_relaxed)) {
+                size_t b = next_block.fetch_add(1, std::memory_order_relaxed);
+                if (b >= block_count) break;
+                if (!fn(w, b)) error_flag = true;
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    perf.stop();
+    energy.stop();
+    return !error_flag;
+}
+
+static bool verify_compressed_blocks(const std::vector<CompressBlock>& blocks, std::vector<uint8_t>& out) {
+    TRACE_SCOPE("inflate_verify");
+    for (const auto& b : blocks) {
+        uLongf out_size = static_cast<uLongf>(out.size());
+        if (uncompress(out.data(), &out_size, b.compressed.data(), b.compressed_size) != Z_OK || out_size != b.size ||
+            crc32(0L, out.data(), static_cast<uInt>(out_size)) != b.crc) return false;
+    }
+    return true;
+}
+
+static jlong run_compress_benchmark(JNIEnv* env, jobject activity, const char* test, const std::vector<int>& cores) {
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    TraceScope setup_trace("compress_setup");
+    std::vector<uint8_t> corpus = build_compress_corpus(get_asset_manager(env, activity));
+
+    std::vector<CompressBlock> blocks;
+    for (size_t offset = 0; offset < corpus.size(); offset += COMPRESS_BLOCK_SIZE) {
+        CompressBlock b;
+        b.data = corpus.data() + offset;
+        b.size = std::min(COMPRESS_BLOCK_SIZE, corpus.size() - offset);
+        b.crc = crc32(0L, b.data, static_cast<uInt>(b.size));
+        b.compressed.resize(compressBound(static_cast<uLong>(b.size)));
+        blocks.push_back(std::move(b));
+    }
+
+    // One decompression scratch block per worker
+    std::vector<std::vector<uint8_t>> scratch(cores.size(), std::vector<uint8_t>(COMPRESS_BLOCK_SIZE));
+    setup_trace.end();
+
+    const size_t level_count = sizeof(COMPRESS_LEVELS) / sizeof(COMPRESS_LEVELS[0]);
+    const int passes = static_cast<int>(size_work(COMPRESS_PASSES));
+    const size_t total_steps = level_count * passes;
+    size_t step = 0;
+    double total_seconds = 0.0;
+    BenchRecord record(test, 0, "ms");
+    record.on_cores(cores).param("corpus_bytes", corpus.size()).param("block_bytes", COMPRESS_BLOCK_SIZE).param("passes", passes);
+
+    for (int level : COMPRESS_LEVELS) {
+        double compress_seconds = 0.0, decompress_seconds = 0.0;
+        size_t compressed_total = 0;
+
+        for (int pass = 0; pass < passes; ++pass) {
+            TraceScope compress_trace("deflate_pass", level);
+            auto c_start = std::chrono::high_resolution_clock::now();
+            bool ok = run_block_pipeline(cores, blocks.size(), [&](size_t, size_t i) {
+                CompressBlock& b = blocks[i];
+                b.compressed_size = static_cast<uLongf>(b.compressed.size());
+                return compress2(b.compressed.data(), &b.compressed_size, b.data, static_cast<uLong>(b.size), level) == Z_OK;
+            });
+            auto c_end = std::chrono::high_resolution_clock::now();
+            compress_trace.end();
+            if (!ok) { LOGE("Compression failed at level %d", level); return -1; }
+
+            TraceScope decompress_trace("inflate_pass", level);
+            auto d_start = std::chrono::high_resolution_clock::now();
+            ok = run_block_pipeline(cores, blocks.size(), [&](size_t worker, size_t i) {
+                std::vector<uint8_t>& out = scratch[worker];
+                const CompressBlock& b = blocks[i];
+                uLongf out_size = static_cast<uLongf>(out.size());
+                return uncompress(out.data(), &out_size, b.compressed.data(), b.compressed_size) == Z_OK &&
+                       out_size == b.size;
+            });
+            auto d_end = std::chrono::high_resolution_clock::now();
+            decompress_trace.end();
+            if (!ok) { LOGE("Decompression failed at level %d", level); return -1; }
+
+            compress_seconds += std::chrono::duration<double>(c_end - c_start).count();
+            decompress_seconds += std::chrono::duration<double>(d_end - d_start).count();
+            compressed_total = 0;
+            for (const auto& b : blocks) compressed_total += b.compressed_size;
+
+            update_progress(env, activity, updateProgressMethod, static_cast<float>(++step) / total_steps);
+        }
+
+        // Untimed: inflate the last pass's blocks once more and check them against the input crc32
+        if (!verify_compressed_blocks(blocks, scratch[0])) {
+            LOGE("Verification failed at level %d", level);
+            return -1;
+        }
+
+        double mb = passes * corpus.size() / (1024.0 * 1024.0);
+        LOGI("Deflate level %d, %zu thread(s): compress %.1f MB/s, decompress %.1f MB/s, ratio %.3f",
+             level, cores.size(), mb / compress_seconds, mb / decompress_seconds,
+             static_cast<double>(compressed_total) / corpus.size());
+        total_seconds += compress_seconds + decompress_seconds;
+        record.metric("compress_mb_s_level" + std::to_string(level), mb / compress_seconds)
+              .metric("decompress_mb_s_level" + std::to_string(level), mb / decompress_seconds);
+    }
+
+    const jlong ms = static_cast<jlong>(total_seconds * 1000.0);
+    record.result = scale_to_full_work(ms, passes, COMPRESS_PASSES);
+    record.metric("measured_ms", ms);
+    record_result(env, activity, record);
+    return record.result;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCompressSingleCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_compress_benchmark(env, activity, "cpu_compress_single", {get_biggest_core()});
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCompressMultiCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_compress_benchmark(env, activity, "cpu_compress_multi", get_performance_cores());
+}
+
+}
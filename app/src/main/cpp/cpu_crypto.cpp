@@ -11,121 +11,226 @@
 #include <sys/mman.h>
 #include <sys/resource.h>
 #include "utils.h"
-
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
+#include "topology.h"
+
+// Logical work per test: 200 passes over 256 MB, as before, but streamed through cache-sized chunks
+static const unsigned long long CRYPTO_PASS_BYTES = 256ULL * 1024 * 1024;
+static const int CRYPTO_PASSES = 200;
+static const size_t CRYPTO_DEFAULT_CHUNK_SIZE = 256 * 1024;
+static const size_t CRYPTO_MIN_CHUNK_SIZE = 64 * 1024;
+static const size_t CRYPTO_MAX_CHUNK_SIZE = 1024 * 1024;
+static const size_t CRYPTO_MAX_INPUT = 8 * 1024 * 1024;
+
+// CTR counter is the big-endian 128-bit IV; add block_index to it with carry
 void get_ctr_iv_for_block(const unsigned char* base_iv, long long block_index, unsigned char* out_iv) {
     memcpy(out_iv, base_iv, 16);
-    auto counter = (unsigned long long*)(out_iv + 8);
-    *counter += block_index;
+    auto carry = static_cast<unsigned long long>(block_index);
+    for (int i = 15; i >= 0 && carry; --i) {
+        carry += out_iv[i];
+        out_iv[i] = static_cast<unsigned char>(carry & 0xFF);
+        carry >>= 8;
+    }
 }
 
-
-extern "C" {
-
-JNIEXPORT jlong JNICALL
-Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoSingleCoreBenchmark(JNIEnv *env, jobject /*thiz*/, jobject activity) {
-    const int SIZE = 256 * 1024 * 1024;
-    const int ITERATIONS = 200;
-
-    auto *data_in = (unsigned char*)aligned_alloc(64, SIZE);
-    auto *data_encrypted = (unsigned char*)aligned_alloc(64, SIZE);
-    auto *data_decrypted = (unsigned char*)aligned_alloc(64, SIZE);
-
-    if (!data_in || !data_encrypted || !data_decrypted) {
-        free(data_in); free(data_encrypted); free(data_decrypted);
-        return -1; // Memory allocation error
+// Word-wise hash for verification; only used outside the timed loops
+static uint64_t rolling_hash64(const unsigned char* data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0x100000001b3ULL;
+        h ^= h >> 29;
     }
+    for (; i < size; ++i) h = (h ^ data[i]) * 0x100000001b3ULL;
+    return h;
+}
 
-    for (size_t i = 0; i < SIZE; i++) data_in[i] = (unsigned char)(i & 0xFF);
-    mlock(data_in, SIZE); mlock(data_encrypted, SIZE); mlock(data_decrypted, SIZE);
-
-    unsigned char key[32]; memset(key, 0x11, sizeof(key));
-    unsigned char iv[16];  memset(iv, 0x22, sizeof(iv));
-
-    jclass activityClass = env->GetObjectClass(activity);
-    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+// Shared plaintext, split into chunks with precomputed hashes
+struct CryptoInput {
+    unsigned char* data = nullptr;
+    size_t size = 0;
+    size_t chunk_size = 0;
+    size_t chunk_count = 0;
+    std::vector<uint64_t> chunk_hashes;
+};
+
+// Per-thread state: one context per direction, initialised with the key once and re-seeded with an IV per chunk
+struct CryptoWorker {
+    EVP_CIPHER_CTX* enc_ctx = nullptr;
+    EVP_CIPHER_CTX* dec_ctx = nullptr;
+    unsigned char* enc_buf = nullptr;
+    unsigned char* dec_buf = nullptr;
+};
+
+// Input size = what is left of the budget after every thread's two chunk buffers, capped at 8 MB so the
+// chunks cycle through a small, page-locked working set (it does not fit the caches of most SoCs)
+static bool crypto_input_init(CryptoInput& in, size_t memory_budget, unsigned int threads, size_t chunk_size) {
+    TRACE_SCOPE("crypto_input_init");
+    size_t per_thread = 2 * chunk_size;
+    size_t available = memory_budget > per_thread * threads ? memory_budget - per_thread * threads : 0;
+    size_t size = std::min(CRYPTO_MAX_INPUT, available) / chunk_size * chunk_size;
+    if (size == 0) size = chunk_size;
+
+    in.data = (unsigned char*)aligned_alloc(64, size);
+    if (!in.data) return false;
+    for (size_t i = 0; i < size; i++) in.data[i] = (unsigned char)(i & 0xFF);
+    mlock(in.data, size);
+
+    in.size = size;
+    in.chunk_size = chunk_size;
+    in.chunk_count = size / chunk_size;
+    in.chunk_hashes.resize(in.chunk_count);
+    for (size_t c = 0; c < in.chunk_count; ++c) in.chunk_hashes[c] = rolling_hash64(in.data + c * chunk_size, chunk_size);
+    LOGI("Crypto stream: input %zu KB, chunk %zu KB, %u thread(s), budget %zu MB",
+         size / 1024, chunk_size / 1024, threads, memory_budget / (1024 * 1024));
+    return true;
+}
 
-    update_progress(env, activity, updateProgressMethod, 0.0f);
-    auto total_start = std::chrono::high_resolution_clock::now();
+static void crypto_input_free(CryptoInput& in) {
+    if (!in.data) return;
+    munlock(in.data, in.size);
+    free(in.data);
+    in.data = nullptr;
+}
 
-    int big_core = get_biggest_core();
-    pin_to_core(big_core);
+static void crypto_worker_free(CryptoWorker& w) {
+    if (w.enc_ctx) EVP_CIPHER_CTX_free(w.enc_ctx);
+    if (w.dec_ctx) EVP_CIPHER_CTX_free(w.dec_ctx);
+    free(w.enc_buf);
+    free(w.dec_buf);
+    w = CryptoWorker{};
+}
 
-    if (setpriority(PRIO_PROCESS, 0, -10) != 0) {
-        LOGE("Failed to set thread priority");
+static bool crypto_worker_init(CryptoWorker& w, size_t chunk_size, const unsigned char* key) {
+    w.enc_ctx = EVP_CIPHER_CTX_new();
+    w.dec_ctx = EVP_CIPHER_CTX_new();
+    w.enc_buf = (unsigned char*)aligned_alloc(64, chunk_size);
+    w.dec_buf = (unsigned char*)aligned_alloc(64, chunk_size);
+    if (!w.enc_ctx || !w.dec_ctx || !w.enc_buf || !w.dec_buf ||
+        1 != EVP_EncryptInit_ex(w.enc_ctx, EVP_aes_256_ctr(), nullptr, key, nullptr) ||
+        1 != EVP_DecryptInit_ex(w.dec_ctx, EVP_aes_256_ctr(), nullptr, key, nullptr)) {
+        crypto_worker_free(w);
+        return false;
     }
+    prefault_pages(w.enc_buf, chunk_size);
+    prefault_pages(w.dec_buf, chunk_size);
+    return true;
+}
 
-    for (int i = 0; i < ITERATIONS; ++i) {
-        // Encrypt
-        EVP_CIPHER_CTX *ctx_enc = EVP_CIPHER_CTX_new();
-        if (!ctx_enc) { return -2; }
-        if (1 != EVP_EncryptInit_ex(ctx_enc, EVP_aes_256_ctr(), nullptr, key, iv)) { return -3; }
-        int encrypted_len = 0;
-        if (1 != EVP_EncryptUpdate(ctx_enc, data_encrypted, &encrypted_len, data_in, SIZE)) { return -4; }
-        int tmplen = 0;
-        if (1 != EVP_EncryptFinal_ex(ctx_enc, data_encrypted + encrypted_len, &tmplen)) { return -5; }
-        EVP_CIPHER_CTX_free(ctx_enc);
-
-        update_progress(env, activity, updateProgressMethod, (float)(i * 2 + 1) / (ITERATIONS * 2));
-
-        // Decrypt
-        EVP_CIPHER_CTX *ctx_dec = EVP_CIPHER_CTX_new();
-        if (!ctx_dec) { return -6; }
-        if (1 != EVP_DecryptInit_ex(ctx_dec, EVP_aes_256_ctr(), nullptr, key, iv)) { return -7; }
-        int decrypted_len = 0;
-        if (1 != EVP_DecryptUpdate(ctx_dec, data_decrypted, &decrypted_len, data_encrypted, encrypted_len + tmplen)) { return -8; }
-        int tmplen2 = 0;
-        if (1 != EVP_DecryptFinal_ex(ctx_dec, data_decrypted + decrypted_len, &tmplen2)) { return -9; }
-        EVP_CIPHER_CTX_free(ctx_dec);
+// Encrypts and decrypts chunk `chunk_index` of the stream starting at base_iv.
+// The IV is derived from the chunk's stream offset, so chunks can be processed in any order on any thread.
+// Returns false on EVP error; the output is only checked by the crypto_verify_* helpers, after the clock stops.
+static bool crypto_process_chunk(CryptoWorker& w, const CryptoInput& in, const unsigned char* base_iv,
+                                 unsigned long long chunk_index) {
+    TRACE_SCOPE("crypto_chunk", static_cast<int64_t>(chunk_index));
+    size_t input_chunk = chunk_index % in.chunk_count;
+    const unsigned char* src = in.data + input_chunk * in.chunk_size;
+    int len = static_cast<int>(in.chunk_size);
+
+    unsigned char iv[16];
+    get_ctr_iv_for_block(base_iv, static_cast<long long>(chunk_index * (in.chunk_size / 16)), iv);
+
+    int outlen = 0;
+    if (1 != EVP_EncryptInit_ex(w.enc_ctx, nullptr, nullptr, nullptr, iv)) return false;
+    if (1 != EVP_EncryptUpdate(w.enc_ctx, w.enc_buf, &outlen, src, len)) return false;
+    if (1 != EVP_DecryptInit_ex(w.dec_ctx, nullptr, nullptr, nullptr, iv)) return false;
+    return 1 == EVP_DecryptUpdate(w.dec_ctx, w.dec_buf, &outlen, w.enc_buf, len);
+}
 
-        update_progress(env, activity, updateProgressMethod, (float)(i * 2 + 2) / (ITERATIONS * 2));
-    }
+// True if the worker's decrypt buffer hashes like the plaintext of chunk `chunk_index`, the last one it processed
+static bool crypto_verify_chunk(const CryptoWorker& w, const CryptoInput& in, unsigned long long chunk_index) {
+    return rolling_hash64(w.dec_buf, in.chunk_size) == in.chunk_hashes[chunk_index % in.chunk_count];
+}
 
-    if (memcmp(data_in, data_decrypted, SIZE) != 0) {
-        munlock(data_in, SIZE); munlock(data_encrypted, SIZE); munlock(data_decrypted, SIZE);
-        free(data_in); free(data_encrypted); free(data_decrypted);
-        return -10;
+// One extra, untimed pass over every input chunk of the stream starting at base_iv, each decrypted chunk
+// compared with the input hash
+static bool crypto_verify_pass(CryptoWorker& w, const CryptoInput& in, const unsigned char* base_iv) {
+    TRACE_SCOPE("crypto_verify_pass");
+    for (size_t c = 0; c < in.chunk_count; ++c) {
+        if (!crypto_process_chunk(w, in, base_iv, c) || !crypto_verify_chunk(w, in, c)) return false;
     }
+    return true;
+}
 
-    auto total_end = std::chrono::high_resolution_clock::now();
-    update_progress(env, activity, updateProgressMethod, 1.0f);
-
-    long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
-    
-    munlock(data_in, SIZE); munlock(data_encrypted, SIZE); munlock(data_decrypted, SIZE);
-    free(data_in); free(data_encrypted); free(data_decrypted);
-    return duration_ms;
+static size_t crypto_memory_budget(jint memory_budget_mb) {
+    return static_cast<size_t>(std::max(1, static_cast<int>(memory_budget_mb))) * 1024 * 1024;
 }
 
-JNIEXPORT jlong JNICALL
-Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoMultiCoreBenchmark(
-        JNIEnv *env, jobject thiz, jobject activity) {
+// Chunk = largest power of two that fits the input chunk plus both output buffers in the smallest L2
+// of the cores that will run the test (a power of two always divides CRYPTO_PASS_BYTES)
+static size_t crypto_chunk_size(const std::vector<int>& cores) {
+    const CpuTopology& topo = get_cpu_topology();
+    size_t l2 = 0;
+    for (int cpu : cores) {
+        size_t size = topo.cache_size(2, cpu);
+        if (size > 0 && (l2 == 0 || size < l2)) l2 = size;
+    }
+    if (l2 == 0) return CRYPTO_DEFAULT_CHUNK_SIZE;
 
-    const int SIZE = 256 * 1024 * 1024;
-    const int TOTAL_ITERATIONS = 200;
+    size_t chunk = CRYPTO_MIN_CHUNK_SIZE;
+    while (chunk * 2 <= CRYPTO_MAX_CHUNK_SIZE && chunk * 2 * 3 <= l2) chunk *= 2;
+    return chunk;
+}
 
+// Runs the multi-threaded variants. Each thread owns one CryptoWorker and claims chunks from a shared counter.
+// parallel_ctr means one continuous CTR stream split across cores;
+// otherwise every pass over CRYPTO_PASS_BYTES is an independent stream with its own IV, as in the original test.
+static jlong run_crypto_multicore(JNIEnv* env, jobject activity, jint memory_budget_mb, bool parallel_ctr) {
     std::vector<int> perf_cores = get_performance_cores();
     const unsigned int num_cores = perf_cores.size();
 
-    // General enter buffer
-    unsigned char* data_in = (unsigned char*)aligned_alloc(64, SIZE);
-    if (!data_in) return -1;
-    for (size_t i = 0; i < SIZE; i++) data_in[i] = (unsigned char)(i & 0xFF);
+    CryptoInput input;
+    if (!crypto_input_init(input, crypto_memory_budget(memory_budget_mb), num_cores, crypto_chunk_size(perf_cores))) return -1;
+
+    const unsigned long long chunks_per_stream = CRYPTO_PASS_BYTES / input.chunk_size;
+    const long long passes = size_work(CRYPTO_PASSES);
+    const unsigned long long total_chunks = passes * (CRYPTO_PASS_BYTES / input.chunk_size);
+    const unsigned long long progress_step = std::max<unsigned long long>(1, total_chunks / 100);
+
+    unsigned char key[32]; memset(key, 0x11, 32);
+    unsigned char base_iv[16]; memset(base_iv, 0x22, 16);
+
+    // Reference for parallel-CTR: chunk 1 encrypted by one context running the stream serially from base_iv
+    std::vector<unsigned char> serial;
+    if (parallel_ctr) {
+        EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+        serial.resize(2 * input.chunk_size);
+        std::vector<unsigned char> plain(2 * input.chunk_size);
+        memcpy(plain.data(), input.data, input.chunk_size);
+        memcpy(plain.data() + input.chunk_size, input.data + (1 % input.chunk_count) * input.chunk_size, input.chunk_size);
+        int outlen = 0;
+        bool ok = ctx && 1 == EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, key, base_iv) &&
+                  1 == EVP_EncryptUpdate(ctx, serial.data(), &outlen, plain.data(), static_cast<int>(plain.size()));
+        if (ctx) EVP_CIPHER_CTX_free(ctx);
+        if (!ok) { crypto_input_free(input); return -2; }
+    }
 
     jobject activity_global_ref = env->NewGlobalRef(activity);
     jclass activity_class = env->GetObjectClass(activity_global_ref);
     jmethodID update_progress_method_id = env->GetMethodID(activity_class, "updateBenchmarkProgress", "(F)V");
 
-    std::atomic<int> next_iteration{0};
-    std::atomic<int> progress_counter{0};
+    std::atomic<unsigned long long> next_chunk{0};
+    std::atomic<unsigned long long> progress_counter{0};
     std::atomic<bool> error_flag{false};
+    // Workers outlive their threads so the last chunk of each can be verified after the clock stops
+    std::vector<CryptoWorker> workers(num_cores);
+    std::vector<long long> last_chunk(num_cores, -1);
 
+    EnergyRegion energy;
     auto total_start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;
     std::vector<std::thread> threads;
 
     for (unsigned int t = 0; t < num_cores; ++t) {
         int target_core = perf_cores[t];
 
-        threads.emplace_back([=, &next_iteration, &progress_counter, &error_flag, &data_in]() {
+        threads.emplace_back([=, &next_chunk, &progress_counter, &error_flag, &input, &key, &base_iv, &workers, &last_chunk]() {
             JNIEnv* thread_env;
             if (g_vm->AttachCurrentThread(&thread_env, nullptr) != JNI_OK) {
                 error_flag = true; return;
@@ -134,62 +239,167 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoMultiCoreBe
             pin_to_core(target_core);
             setpriority(PRIO_PROCESS, 0, -10);
 
-            unsigned char* t_enc = (unsigned char*)aligned_alloc(64, SIZE);
-            unsigned char* t_dec = (unsigned char*)aligned_alloc(64, SIZE);
-
-            if (!t_enc || !t_dec) {
+            CryptoWorker& worker = workers[t];
+            if (!crypto_worker_init(worker, input.chunk_size, key)) {
                 error_flag = true;
             } else {
-                unsigned char key[32]; memset(key, 0x11, 32);
-                unsigned char base_iv[16]; memset(base_iv, 0x22, 16);
-
                 while (true) {
-                    int iter = next_iteration.fetch_add(1);
-                    if (iter >= TOTAL_ITERATIONS || error_flag.load()) break;
-
-                    unsigned char thread_iv[16];
-                    get_ctr_iv_for_block(base_iv, (long long)iter * (SIZE / 16), thread_iv);
-
-                    // Encrypt
-                    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
-                    int outlen = 0;
-                    EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, key, thread_iv);
-                    EVP_EncryptUpdate(ctx, t_enc, &outlen, data_in, SIZE);
-                    EVP_CIPHER_CTX_free(ctx);
-
-                    // Decrypt
-                    ctx = EVP_CIPHER_CTX_new();
-                    EVP_DecryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, key, thread_iv);
-                    EVP_DecryptUpdate(ctx, t_dec, &outlen, t_enc, SIZE);
-                    EVP_CIPHER_CTX_free(ctx);
-
-                    // Check
-                    if (memcmp(data_in, t_dec, SIZE) != 0) error_flag = true;
-
-                    // Progress
-                    int p = progress_counter.fetch_add(2) + 2;
-                    if (iter % 5 == 0) {
-                        thread_env->CallVoidMethod(activity_global_ref, update_progress_method_id, (float)p / (TOTAL_ITERATIONS * 2));
+                    unsigned long long chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= total_chunks || error_flag.load(std::memory_order_relaxed)) break;
+
+                    unsigned long long stream_chunk = chunk;
+                    unsigned char stream_iv[16];
+                    if (parallel_ctr) {
+                        memcpy(stream_iv, base_iv, 16);
+                    } else {
+                        // Independent stream per pass, offset like the original per-iteration IVs
+                        unsigned long long pass = chunk / chunks_per_stream;
+                        stream_chunk = chunk % chunks_per_stream;
+                        get_ctr_iv_for_block(base_iv, (long long)(pass * (CRYPTO_PASS_BYTES / 16)), stream_iv);
+                    }
+
+                    if (!crypto_process_chunk(worker, input, stream_iv, stream_chunk)) {
+                        error_flag = true;
+                        break;
+                    }
+                    last_chunk[t] = static_cast<long long>(stream_chunk);
+
+                    unsigned long long p = progress_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+                    if (p % progress_step == 0) {
+                        thread_env->CallVoidMethod(activity_global_ref, update_progress_method_id, (float)p / total_chunks);
                     }
                 }
             }
 
-            // Clean before exit from thread
-            if (t_enc) free(t_enc);
-            if (t_dec) free(t_dec);
             g_vm->DetachCurrentThread();
         });
     }
 
     for (auto &th : threads) th.join();
+    perf.stop();
+
+    auto total_end = std::chrono::high_resolution_clock::now();
+    energy.stop();
 
-    free(data_in);
+    // Untimed: every worker's last output, one pass over all input chunks, and for parallel-CTR chunk 1
+    // against the serial stream
+    bool verified = !error_flag;
+    for (unsigned int t = 0; verified && t < num_cores; ++t) {
+        if (last_chunk[t] >= 0) verified = crypto_verify_chunk(workers[t], input, last_chunk[t]);
+    }
+    if (verified) verified = crypto_verify_pass(workers[0], input, base_iv);
+    if (verified && parallel_ctr) {
+        verified = crypto_process_chunk(workers[0], input, base_iv, 1) &&
+                   memcmp(workers[0].enc_buf, serial.data() + input.chunk_size, input.chunk_size) == 0;
+    }
+    for (auto& worker : workers) crypto_worker_free(worker);
+    crypto_input_free(input);
     env->DeleteGlobalRef(activity_global_ref);
 
-    if (error_flag) return -11;
+    if (!verified) return -11;
+
+    long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
+    double mb_per_s = duration_ms > 0 ? 2.0 * total_chunks * input.chunk_size / (1024.0 * 1024.0) / (duration_ms / 1000.0) : 0.0;
+    if (duration_ms > 0) {
+        LOGI("Crypto %s: %.1f MB/s (encrypt + decrypt)", parallel_ctr ? "parallel-CTR" : "multi-stream", mb_per_s);
+    }
+    jlong full_ms = scale_to_full_work(duration_ms, passes, CRYPTO_PASSES);
+    record_result(env, activity, BenchRecord(parallel_ctr ? "cpu_crypto_parallel_ctr" : "cpu_crypto_multi", full_ms, "ms")
+            .on_cores(perf_cores).metric("mb_per_s", mb_per_s).metric("measured_ms", duration_ms)
+            .param("chunk_bytes", input.chunk_size).param("chunks", total_chunks).param("memory_budget_mb", memory_budget_mb));
+    return full_ms;
+}
+
 
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoSingleCoreBenchmark(JNIEnv *env, jobject /*thiz*/, jobject activity, jint memory_budget_mb) {
+    int big_core = get_biggest_core();
+
+    CryptoInput input;
+    if (!crypto_input_init(input, crypto_memory_budget(memory_budget_mb), 1, crypto_chunk_size({big_core}))) {
+        return -1; // Memory allocation error
+    }
+
+    unsigned char key[32]; memset(key, 0x11, sizeof(key));
+    unsigned char iv[16];  memset(iv, 0x22, sizeof(iv));
+
+    CryptoWorker worker;
+    if (!crypto_worker_init(worker, input.chunk_size, key)) {
+        crypto_input_free(input);
+        return -2;
+    }
+
+    const long long passes = size_work(CRYPTO_PASSES);
+    const unsigned long long total_chunks = passes * (CRYPTO_PASS_BYTES / input.chunk_size);
+    const unsigned long long progress_step = std::max<unsigned long long>(1, total_chunks / 100);
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    update_progress(env, activity, updateProgressMethod, 0.0f);
+
+    pin_to_core(big_core);
+
+    if (setpriority(PRIO_PROCESS, 0, -10) != 0) {
+        LOGE("Failed to set thread priority");
+    }
+
+    EnergyRegion energy;
+    auto total_start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;
+
+    for (unsigned long long chunk = 0; chunk < total_chunks; ++chunk) {
+        if (!crypto_process_chunk(worker, input, iv, chunk)) {
+            crypto_worker_free(worker);
+            crypto_input_free(input);
+            return -10;
+        }
+
+        if ((chunk + 1) % progress_step == 0) {
+            update_progress(env, activity, updateProgressMethod, (float)(chunk + 1) / total_chunks);
+        }
+    }
+
+    perf.stop();
     auto total_end = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
+    energy.stop();
+    update_progress(env, activity, updateProgressMethod, 1.0f);
+
+    // Untimed: the last chunk of the timed loop, then one pass over all input chunks
+    if ((total_chunks > 0 && !crypto_verify_chunk(worker, input, total_chunks - 1)) ||
+        !crypto_verify_pass(worker, input, iv)) {
+        crypto_worker_free(worker);
+        crypto_input_free(input);
+        return -10;
+    }
+
+    long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(total_end - total_start).count();
+    double mb_per_s = duration_ms > 0 ? 2.0 * total_chunks * input.chunk_size / (1024.0 * 1024.0) / (duration_ms / 1000.0) : 0.0;
+    if (duration_ms > 0) {
+        LOGI("Crypto single-core: %.1f MB/s (encrypt + decrypt)", mb_per_s);
+    }
+    jlong full_ms = scale_to_full_work(duration_ms, passes, CRYPTO_PASSES);
+    record_result(env, activity, BenchRecord("cpu_crypto_single", full_ms, "ms")
+            .on_core(big_core).metric("mb_per_s", mb_per_s).metric("measured_ms", duration_ms)
+            .param("chunk_bytes", input.chunk_size).param("chunks", total_chunks).param("memory_budget_mb", memory_budget_mb));
+
+    crypto_worker_free(worker);
+    crypto_input_free(input);
+    return full_ms;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoMultiCoreBenchmark(
+        JNIEnv *env, jobject /*thiz*/, jobject activity, jint memory_budget_mb) {
+    return run_crypto_multicore(env, activity, memory_budget_mb, false);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuCryptoParallelCtrBenchmark(
+        JNIEnv *env, jobject /*thiz*/, jobject activity, jint memory_budget_mb) {
+    return run_crypto_multicore(env, activity, memory_budget_mb, true);
 }
 
 }
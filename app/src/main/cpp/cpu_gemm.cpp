@@ -0,0 +1,279 @@
+#include <jni.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <sys/resource.h>
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+#include "utils.h"
+#include "topology.h"
+#include "cpu_gemm.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
+
+// Goto-style SGEMM: C is cut into MC x NC tasks that the threads pull from a shared counter.
+// Inside a task, every KC slice packs an MR-row panel layout of A (kept in L2) and an NR-column
+// panel layout of B, and the micro-kernel keeps an MR x NR block of C in registers.
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+static const int SGEMM_MR = 8;
+static const int SGEMM_NR = 12;     // 8 x 3 float32x4 accumulators
+#elif defined(__AVX2__) && defined(__FMA__)
+static const int SGEMM_MR = 6;
+static const int SGEMM_NR = 16;     // 6 x 2 __m256 accumulators
+#else
+static const int SGEMM_MR = 4;
+static const int SGEMM_NR = 8;
+#endif
+static const int SGEMM_KC = 256;
+static const int SGEMM_NC = SGEMM_NR * 32;
+
+static const int SGEMM_BENCH_SIZE = 2048;
+static const int SGEMM_BENCH_REPEATS = 6;
+static const int SGEMM_BENCH_SAMPLES = 256;
+
+// MR x NR block of C (row stride ldc) = or += packed A panel * packed B panel over kc
+static void sgemm_micro_kernel(int kc, const float* ap, const float* bp, float* c, size_t ldc, bool accumulate) {
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    float32x4_t acc[SGEMM_MR][3];
+    for (int r = 0; r < SGEMM_MR; ++r) acc[r][0] = acc[r][1] = acc[r][2] = vdupq_n_f32(0.0f);
+    for (int p = 0; p < kc; ++p, ap += SGEMM_MR, bp += SGEMM_NR) {
+        float32x4_t b0 = vld1q_f32(bp), b1 = vld1q_f32(bp + 4), b2 = vld1q_f32(bp + 8);
+        for (int r = 0; r < SGEMM_MR; ++r) {
+            acc[r][0] = vfmaq_n_f32(acc[r][0], b0, ap[r]);
+            acc[r][1] = vfmaq_n_f32(acc[r][1], b1, ap[r]);
+            acc[r][2] = vfmaq_n_f32(acc[r][2], b2, ap[r]);
+        }
+    }
+    for (int r = 0; r < SGEMM_MR; ++r) {
+        float* row = c + r * ldc;
+        for (int v = 0; v < 3; ++v) {
+            float32x4_t out = accumulate ? vaddq_f32(vld1q_f32(row + v * 4), acc[r][v]) : acc[r][v];
+            vst1q_f32(row + v * 4, out);
+        }
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 acc[SGEMM_MR][2];
+    for (int r = 0; r < SGEMM_MR; ++r) acc[r][0] = acc[r][1] = _mm256_setzero_ps();
+    for (int p = 0; p < kc; ++p, ap += SGEMM_MR, bp += SGEMM_NR) {
+        __m256 b0 = _mm256_loadu_ps(bp), b1 = _mm256_loadu_ps(bp + 8);
+        for (int r = 0; r < SGEMM_MR; ++r) {
+            __m256 a = _mm256_broadcast_ss(ap + r);
+            acc[r][0] = _mm256_fmadd_ps(a, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(a, b1, acc[r][1]);
+        }
+    }
+    for (int r = 0; r < SGEMM_MR; ++r) {
+        float* row = c + r * ldc;
+        for (int v = 0; v < 2; ++v) {
+            __m256 out = accumulate ? _mm256_add_ps(_mm256_loadu_ps(row + v * 8), acc[r][v]) : acc[r][v];
+            _mm256_storeu_ps(row + v * 8, out);
+        }
+    }
+#else
+    float acc[SGEMM_MR][SGEMM_NR] = {};
+    for (int p = 0; p < kc; ++p, ap += SGEMM_MR, bp += SGEMM_NR) {
+        for (int r = 0; r < SGEMM_MR; ++r) {
+            for (int j = 0; j < SGEMM_NR; ++j) acc[r][j] += ap[r] * bp[j];
+        }
+    }
+    for (int r = 0; r < SGEMM_MR; ++r) {
+        for (int j = 0; j < SGEMM_NR; ++j) c[r * ldc + j] = accumulate ? c[r * ldc + j] + acc[r][j] : acc[r][j];
+    }
+#endif
+}
+
+// mc x kc block of A -> MR-row panels, column by column, zero-padded to a multiple of MR
+static void sgemm_pack_a(int mc, int kc, const float* a, size_t lda, float* out) {
+    for (int i = 0; i < mc; i += SGEMM_MR) {
+        const int rows = std::min(SGEMM_MR, mc - i);
+        for (int p = 0; p < kc; ++p) {
+            for (int r = 0; r < SGEMM_MR; ++r) *out++ = r < rows ? a[(i + r) * lda + p] : 0.0f;
+        }
+    }
+}
+
+// kc x nc block of B -> NR-column panels, row by row, zero-padded to a multiple of NR
+static void sgemm_pack_b(int kc, int nc, const float* b, size_t ldb, float* out) {
+    for (int j = 0; j < nc; j += SGEMM_NR) {
+        const int cols = std::min(SGEMM_NR, nc - j);
+        for (int p = 0; p < kc; ++p) {
+            const float* row = b + p * ldb + j;
+            if (cols == SGEMM_NR) {
+                std::copy(row, row + SGEMM_NR, out);
+                out += SGEMM_NR;
+            } else {
+                for (int c = 0; c < SGEMM_NR; ++c) *out++ = c < cols ? row[c] : 0.0f;
+            }
+        }
+    }
+}
+
+// Rows of A per task: the packed A block should take about half of the smallest L2
+static int sgemm_block_rows(const std::vector<int>& cores) {
+    const CpuTopology& topo = get_cpu_topology();
+    size_t l2 = 0;
+    for (int cpu : cores) {
+        size_t size = topo.cache_size(2, cpu);
+        if (size > 0 && (l2 == 0 || size < l2)) l2 = size;
+    }
+    if (l2 == 0) l2 = 512 * 1024;
+    int rows = static_cast<int>(l2 / 2 / (SGEMM_KC * sizeof(float)));
+    rows = std::max(SGEMM_MR * 4, std::min(rows, 512));
+    return rows / SGEMM_MR * SGEMM_MR;
+}
+
+void sgemm(int n, int m, int k, const float* a, size_t lda, const float* b, size_t ldb, float* c, size_t ldc,
+           const std::vector<int>& cores) {
+    if (n <= 0 || m <= 0) return;
+    if (k <= 0) {
+        for (int i = 0; i < n; ++i) std::fill(c + i * ldc, c + i * ldc + m, 0.0f);
+        return;
+    }
+
+    const int mc_max = sgemm_block_rows(cores);
+    const int row_tasks = (n + mc_max - 1) / mc_max;
+    const int col_tasks = (m + SGEMM_NC - 1) / SGEMM_NC;
+    const int total_tasks = row_tasks * col_tasks;
+    std::atomic<int> next_task{0};
+
+    auto worker = [&]() {
+        std::vector<float> packed_a(static_cast<size_t>(mc_max) * SGEMM_KC);
+        std::vector<float> packed_b(static_cast<size_t>(SGEMM_NC) * SGEMM_KC);
+        float edge[SGEMM_MR * SGEMM_NR];
+
+        for (int task = next_task.fetch_add(1); task < total_tasks; task = next_task.fetch_add(1)) {
+            TRACE_SCOPE("sgemm_task", task);
+            const int ic = (task / col_tasks) * mc_max;
+            const int jc = (task % col_tasks) * SGEMM_NC;
+            const int mc = std::min(mc_max, n - ic);
+            const int nc = std::min(SGEMM_NC, m - jc);
+
+            for (int pc = 0; pc < k; pc += SGEMM_KC) {
+                const int kc = std::min(SGEMM_KC, k - pc);
+                const bool accumulate = pc > 0;
+                sgemm_pack_a(mc, kc, a + ic * lda + pc, lda, packed_a.data());
+                sgemm_pack_b(kc, nc, b + pc * ldb + jc, ldb, packed_b.data());
+
+                for (int jr = 0; jr < nc; jr += SGEMM_NR) {
+                    const float* bp = packed_b.data() + static_cast<size_t>(jr) * kc;
+                    const int cols = std::min(SGEMM_NR, nc - jr);
+                    for (int ir = 0; ir < mc; ir += SGEMM_MR) {
+                        const float* ap = packed_a.data() + static_cast<size_t>(ir) * kc;
+                        const int rows = std::min(SGEMM_MR, mc - ir);
+                        float* ct = c + (ic + ir) * ldc + jc + jr;
+                        if (rows == SGEMM_MR && cols == SGEMM_NR) {
+                            sgemm_micro_kernel(kc, ap, bp, ct, ldc, accumulate);
+                            continue;
+                        }
+                        // Edge block: compute the full padded tile aside and keep only the valid part
+                        sgemm_micro_kernel(kc, ap, bp, edge, SGEMM_NR, false);
+                        for (int r = 0; r < rows; ++r) {
+                            for (int j = 0; j < cols; ++j) {
+                                ct[r * ldc + j] = accumulate ? ct[r * ldc + j] + edge[r * SGEMM_NR + j] : edge[r * SGEMM_NR + j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    if (cores.size() <= 1) {
+        worker();
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(cores.size());
+    for (int core : cores) {
+        threads.emplace_back([&, core]() {
+            pin_to_core(core);
+            setpriority(PRIO_PROCESS, 0, -10);
+            worker();
+        });
+    }
+    for (auto& th : threads) th.join();
+}
+
+extern "C" {
+
+// 2048^3 SGEMM repeated on the performance cores. Returns the total time in ms, negative if the result is wrong.
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuSgemmBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    const int size = SGEMM_BENCH_SIZE;
+    const size_t elements = static_cast<size_t>(size) * size;
+    std::vector<float> a(elements), b(elements), c(elements);
+    std::mt19937 rng(0x5eed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (auto& v : a) v = dist(rng);
+    for (auto& v : b) v = dist(rng);
+
+    std::vector<int> cores = get_performance_cores();
+
+    // Untimed pass: faults the pages in and gives the result to check
+    sgemm(size, size, size, a.data(), size, b.data(), size, c.data(), size, cores);
+
+    for (int s = 0; s < SGEMM_BENCH_SAMPLES; ++s) {
+        const size_t i = rng() % size, j = rng() % size;
+        double expected = 0.0, magnitude = 0.0;
+        for (int p = 0; p < size; ++p) {
+            double prod = static_cast<double>(a[i * size + p]) * b[p * size + j];
+            expected += prod;
+            magnitude += std::fabs(prod);
+        }
+        if (std::fabs(c[i * size + j] - expected) > 1e-4 * magnitude + 1e-3) {
+            LOGE("SGEMM: C[%zu][%zu] = %f, expected %f", i, j, c[i * size + j], expected);
+            return -1;
+        }
+    }
+
+    int repeats = static_cast<int>(size_work(SGEMM_BENCH_REPEATS));
+    auto timed_repeats = [&]() {
+        EnergyRegion energy;
+        auto start = std::chrono::high_resolution_clock::now();
+        PerfRegion perf;
+        for (int r = 0; r < repeats; ++r) {
+            TRACE_SCOPE("sgemm_repeat", r);
+            sgemm(size, size, size, a.data(), size, b.data(), size, c.data(), size, cores);
+            update_progress(env, activity, updateProgressMethod, static_cast<float>(r + 1) / repeats);
+        }
+        perf.stop();
+        auto end = std::chrono::high_resolution_clock::now();
+        energy.stop();
+        return std::chrono::duration<double>(end - start).count();
+    };
+    double seconds = timed_repeats();
+    const int min_duration_repeats = static_cast<int>(
+            work_for_min_duration(static_cast<jlong>(seconds * 1000.0), repeats));
+    if (min_duration_repeats != repeats) {
+        repeats = min_duration_repeats;
+        seconds = timed_repeats();
+    }
+
+    double gflops = 2.0 * size * size * size * repeats / seconds / 1e9;
+    LOGI("SGEMM %dx%dx%d on %zu core(s), MR %d NR %d KC %d: %.1f GFLOPS", size, size, size, cores.size(),
+         SGEMM_MR, SGEMM_NR, SGEMM_KC, gflops);
+    jlong ms = static_cast<jlong>(seconds * 1000.0);
+    jlong full_ms = scale_to_full_work(ms, repeats, SGEMM_BENCH_REPEATS);
+    record_result(env, activity, BenchRecord("cpu_sgemm", full_ms, "ms")
+            .on_cores(cores).metric("gflops", gflops).metric("measured_ms", ms)
+            .param("size", size).param("repeats", repeats).param("mr", SGEMM_MR).param("nr", SGEMM_NR).param("kc", SGEMM_KC));
+    return full_ms;
+}
+
+}
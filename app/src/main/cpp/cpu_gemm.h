@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Row-major single-precision GEMM: C[n x m] = A[n x k] * B[k x m], leading dimensions in elements.
+// Packed and cache-blocked with a NEON/AVX2 micro-kernel; one pinned thread per entry of cores
+// (the calling thread does all the work if cores is empty).
+void sgemm(int n, int m, int k, const float* a, size_t lda, const float* b, size_t ldb, float* c, size_t ldc,
+           const std::vector<int>& cores);
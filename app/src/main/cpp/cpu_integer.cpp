@@ -0,0 +1,310 @@
+#include <jni.h>
+#include <vector>
+#include <string>
+#include <regex>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include "utils.h"
+#include "results.h"
+#include "sizing.h"
+#include "cpu_runner.h"
+
+// Integer and branch-heavy workloads: sorting, hash-map probing, JSON tokenizing and regex matching.
+// One iteration is one job; job i runs kernel (i % 4) with seed i, so the single and multi core runners
+// split exactly the same work. Every job verifies its own result.
+
+static const long long INTEGER_JOBS = 256;
+static const size_t SORT_KEYS_PER_JOB = 1 << 20;       // 64 sort jobs -> 64M keys
+static const size_t HASH_CAPACITY = 1 << 20;
+static const size_t HASH_INSERTS = HASH_CAPACITY / 2;
+static const size_t JSON_CORPUS_BYTES = 4 * 1024 * 1024;
+static const size_t LOG_LINES = 16000;
+static const size_t REGEX_LINES_PER_JOB = 2000;
+
+static std::atomic<bool> g_integer_failed{false};
+
+static inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// --- Shared corpora, generated once outside the timed region ---
+
+struct IntegerCorpus {
+    std::string json;
+    size_t json_tokens = 0;
+    std::vector<std::string> log_lines;
+};
+
+static IntegerCorpus& integer_corpus() {
+    static IntegerCorpus corpus;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        std::mt19937 gen(0x1E7u);
+        std::string& json = corpus.json;
+        size_t& tokens = corpus.json_tokens;
+        auto tok = [&](const std::string& s) { json += s; tokens++; };
+        auto str = [&](size_t len) {
+            std::string s = "\"";
+            for (size_t i = 0; i < len; ++i) {
+                s += (gen() % 23 == 0) ? std::string("\\\"") : std::string(1, static_cast<char>('a' + gen() % 26));
+            }
+            return s + "\"";
+        };
+
+        json.reserve(JSON_CORPUS_BYTES + 4096);
+        tok("[");
+        while (json.size() < JSON_CORPUS_BYTES) {
+            if (json.size() > 1) tok(",");
+            json += "\n  ";
+            tok("{");
+            tok("\"id\""); tok(":"); tok(std::to_string(gen() % 1000000)); tok(",");
+            tok("\"name\""); tok(":"); tok(str(4 + gen() % 20)); tok(",");
+            tok("\"tags\""); tok(":"); tok("[");
+            int tag_count = static_cast<int>(gen() % 5);
+            for (int t = 0; t < tag_count; ++t) {
+                if (t) tok(",");
+                tok(str(3 + gen() % 8));
+            }
+            tok("]"); tok(",");
+            tok("\"score\""); tok(":");
+            int whole = static_cast<int>(gen() % 20000) - 10000;
+            int frac = static_cast<int>(gen() % 100);
+            tok(std::to_string(whole) + "." + std::to_string(frac) + "e-2");
+            tok(",");
+            tok("\"active\""); tok(":"); tok(gen() % 2 ? "true" : "false"); tok(",");
+            tok("\"next\""); tok(":"); tok("null");
+            tok("}");
+        }
+        json += "\n";
+        tok("]");
+
+        static const char* methods[] = {"GET", "POST", "PUT", "DELETE"};
+        static const char* resources[] = {"items", "users", "orders", "sessions", "images"};
+        static const int statuses[] = {200, 200, 200, 201, 204, 301, 304, 400, 404, 500, 502, 503};
+        char line[256];
+        corpus.log_lines.reserve(LOG_LINES);
+        for (size_t i = 0; i < LOG_LINES; ++i) {
+            // Draw the fields in a fixed order (argument evaluation order is unspecified)
+            unsigned f[10];
+            for (auto& v : f) v = static_cast<unsigned>(gen());
+            snprintf(line, sizeof(line),
+                     "10.0.%u.%u - - [18/Oct/2026:12:%02u:%02u +0000] \"%s /api/v%u/%s/%u HTTP/1.1\" %d %u \"okhttp/4.12.0\"",
+                     f[0] % 256, f[1] % 256, f[2] % 60, f[3] % 60, methods[f[4] % 4], 1 + f[5] % 3,
+                     resources[f[6] % 5], f[7] % 100000, statuses[f[8] % 12], f[9] % 50000);
+            corpus.log_lines.emplace_back(line);
+        }
+    });
+    return corpus;
+}
+
+// --- Sorting: LSD radix sort and std::sort on alternating jobs ---
+
+static void radix_sort_u64(std::vector<uint64_t>& keys, std::vector<uint64_t>& tmp) {
+    tmp.resize(keys.size());
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t count[257] = {0};
+        for (uint64_t k : keys) count[((k >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+        for (uint64_t k : keys) tmp[count[(k >> shift) & 0xFF]++] = k;
+        keys.swap(tmp);
+    }
+}
+
+static bool sort_job(long long job) {
+    thread_local std::vector<uint64_t> keys, tmp;
+    keys.resize(SORT_KEYS_PER_JOB);
+    uint64_t state = static_cast<uint64_t>(job);
+    for (auto& k : keys) k = splitmix64(state);
+
+    if ((job / 4) % 2 == 0) {
+        radix_sort_u64(keys, tmp);
+    } else {
+        std::sort(keys.begin(), keys.end());
+    }
+    return std::is_sorted(keys.begin(), keys.end());
+}
+
+// --- Open-addressing hash map (linear probing, key 0 = empty) ---
+
+static bool hash_job(long long job) {
+    thread_local std::vector<uint64_t> slot_keys;
+    thread_local std::vector<uint32_t> slot_values;
+    slot_keys.assign(HASH_CAPACITY, 0);
+    slot_values.resize(HASH_CAPACITY);
+    const size_t mask = HASH_CAPACITY - 1;
+
+    uint64_t state = static_cast<uint64_t>(job) << 32;
+    for (size_t i = 0; i < HASH_INSERTS; ++i) {
+        uint64_t key = splitmix64(state) | 1;
+        size_t s = (key * 0x9E3779B97F4A7C15ULL) >> 44 & mask;
+        while (slot_keys[s] != 0 && slot_keys[s] != key) s = (s + 1) & mask;
+        slot_keys[s] = key;
+        slot_values[s] = static_cast<uint32_t>(i);
+    }
+
+    // Replay the inserted keys interleaved with keys that are absent (even keys are never inserted)
+    state = static_cast<uint64_t>(job) << 32;
+    uint64_t miss_state = ~state;
+    size_t hits = 0;
+    uint64_t value_sum = 0;
+    for (size_t i = 0; i < HASH_INSERTS * 2; ++i) {
+        uint64_t key = (i & 1) ? (splitmix64(miss_state) & ~1ULL) | 2 : splitmix64(state) | 1;
+        size_t s = (key * 0x9E3779B97F4A7C15ULL) >> 44 & mask;
+        while (slot_keys[s] != 0) {
+            if (slot_keys[s] == key) {
+                hits++;
+                value_sum += slot_values[s];
+                break;
+            }
+            s = (s + 1) & mask;
+        }
+    }
+    return hits == HASH_INSERTS && value_sum >= HASH_INSERTS;
+}
+
+// --- JSON tokenizer ---
+
+static bool json_job(const IntegerCorpus& corpus) {
+    const char* p = corpus.json.data();
+    const char* end = p + corpus.json.size();
+    size_t tokens = 0;
+
+    while (p < end) {
+        char c = *p;
+        switch (c) {
+            case ' ': case '\n': case '\r': case '\t':
+                ++p;
+                continue;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                ++p;
+                break;
+            case '"':
+                ++p;
+                while (p < end && *p != '"') p += (*p == '\\') ? 2 : 1;
+                if (p >= end) return false;
+                ++p;
+                break;
+            case 't':
+                if (end - p < 4 || memcmp(p, "true", 4) != 0) return false;
+                p += 4;
+                break;
+            case 'f':
+                if (end - p < 5 || memcmp(p, "false", 5) != 0) return false;
+                p += 5;
+                break;
+            case 'n':
+                if (end - p < 4 || memcmp(p, "null", 4) != 0) return false;
+                p += 4;
+                break;
+            default:
+                if (c != '-' && (c < '0' || c > '9')) return false;
+                ++p;
+                while (p < end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' || *p == '-' || *p == '+')) ++p;
+                break;
+        }
+        tokens++;
+    }
+    return tokens == corpus.json_tokens;
+}
+
+// --- Regex: std::regex and a hand-built DFA searching for a " 5xx " status, counts must agree ---
+
+static size_t dfa_count_5xx(const std::vector<std::string>& lines, size_t first, size_t count) {
+    // States: 0 start, 1 after ' ', 2 after " 5", 3 after " 5d", 4 after " 5dd", 5 match
+    static uint8_t table[5][256];
+    static std::once_flag once;
+    std::call_once(once, [] {
+        for (auto& row : table) memset(row, 0, sizeof(row));
+        for (int s = 0; s < 5; ++s) table[s][' '] = 1;
+        table[1]['5'] = 2;
+        for (int d = '0'; d <= '9'; ++d) { table[2][d] = 3; table[3][d] = 4; }
+        table[4][' '] = 5;
+    });
+
+    size_t matches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const std::string& line = lines[(first + i) % lines.size()];
+        int state = 0;
+        for (unsigned char c : line) {
+            state = table[state][c];
+            if (state == 5) { matches++; break; }
+        }
+    }
+    return matches;
+}
+
+static bool regex_job(long long job, const IntegerCorpus& corpus) {
+    static const std::regex pattern(" 5[0-9]{2} ", std::regex::optimize);
+    const size_t first = static_cast<size_t>(job) * 977 % corpus.log_lines.size();
+
+    size_t regex_matches = 0;
+    for (size_t i = 0; i < REGEX_LINES_PER_JOB; ++i) {
+        if (std::regex_search(corpus.log_lines[(first + i) % corpus.log_lines.size()], pattern)) regex_matches++;
+    }
+    return regex_matches == dfa_count_5xx(corpus.log_lines, first, REGEX_LINES_PER_JOB);
+}
+
+static void integer_range(long long begin, long long end) {
+    const IntegerCorpus& corpus = integer_corpus();
+    for (long long job = begin; job < end; ++job) {
+        bool ok = false;
+        switch (job % 4) {
+            case 0: ok = sort_job(job); break;
+            case 1: ok = hash_job(job); break;
+            case 2: ok = json_job(corpus); break;
+            case 3: ok = regex_job(job, corpus); break;
+        }
+        if (!ok) {
+            LOGE("Integer suite: job %lld (kernel %lld) failed verification", job, job % 4);
+            g_integer_failed = true;
+        }
+    }
+}
+
+static jlong run_integer_benchmark(JNIEnv* env, jobject activity, bool multicore) {
+    integer_corpus();
+    g_integer_failed = false;
+    // Whole rounds of the four kernels so the job mix stays the same in the quick profile
+    long long jobs = size_work(INTEGER_JOBS, 4) / 4 * 4;
+    auto run = [&]() {
+        return multicore ? run_multicore_benchmark(env, activity, jobs, integer_range)
+                         : run_singlecore_benchmark(env, activity, jobs, integer_range);
+    };
+    jlong ms = run();
+    if (g_integer_failed) return -1;
+    const long long min_duration_jobs = work_for_min_duration(ms, jobs, 4);
+    if (min_duration_jobs != jobs) {
+        jobs = min_duration_jobs;
+        ms = run();
+        if (g_integer_failed) return -1;
+    }
+    jlong full_ms = scale_to_full_work(ms, jobs, INTEGER_JOBS);
+    record_result(env, activity, BenchRecord(multicore ? "cpu_integer_multi" : "cpu_integer_single", full_ms, "ms")
+            .metric("jobs_per_s", ms > 0 ? jobs * 1000.0 / ms : 0.0).metric("measured_ms", ms).param("jobs", jobs)
+            .param("threads", multicore ? std::max(1u, std::thread::hardware_concurrency()) : 1));
+    return full_ms;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuIntegerSingleCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_integer_benchmark(env, activity, false);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuIntegerMultiCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_integer_benchmark(env, activity, true);
+}
+
+}
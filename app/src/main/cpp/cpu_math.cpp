@@ -13,6 +13,13 @@
 #include <sys/syscall.h>
 #include <sys/resource.h>
 #include "utils.h"
+#include "cpu_runner.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
+#include "contention.h"
 
 std::atomic<long long> current_iterations_done(0);
 std::atomic<bool> stop_cpu_stress(false);
@@ -39,12 +46,17 @@ inline double heavy_math(double i) {
     return result_final;
 }
 
-extern "C" {
+static void heavy_math_range(long long begin, long long end) {
+    volatile double result = 0;
+    for (auto i = begin; i < end; ++i) {
+        result += heavy_math(static_cast<double>(i));
+    }
+    (void)result;
+}
 
-JNIEXPORT jlong JNICALL
-Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathSingleCoreBenchmark(
-        JNIEnv *env, jobject thiz, jobject activity) {
-    (void)thiz;
+jlong run_singlecore_benchmark(
+        JNIEnv *env, jobject activity, long long total_iterations, const CpuWorkFn& work) {
+    if (total_iterations <= 0) return 0;
     if (activity == nullptr) return 0; // Added null check
     jobject activity_global_ref = env->NewGlobalRef(activity);
     jclass activityClass_local = env->GetObjectClass(activity_global_ref);
@@ -52,16 +64,13 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathSingleCoreBen
     env->DeleteLocalRef(activityClass_local); // Added this line
     jmethodID updateProgressMethod = env->GetMethodID(activity_class_global_ref, "updateBenchmarkProgress", "(F)V");
 
-    const long long total_iterations = 70000000LL;
     current_iterations_done.store(0, std::memory_order_relaxed);
 
     std::thread reporter_thread([activity_global_ref, activity_class_global_ref, updateProgressMethod, total_iterations]() {
         JNIEnv* thread_env = nullptr;
         g_vm->AttachCurrentThread(&thread_env, nullptr);
 
-        int big_core = get_biggest_core();
-        pin_to_core(big_core);
-
+        // Left unpinned so the scheduler keeps it off the measured core
         if (setpriority(PRIO_PROCESS, 0, 0) != 0) {
             LOGE("Failed to set thread priority");
         }
@@ -86,18 +95,27 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathSingleCoreBen
         g_vm->DetachCurrentThread();
     });
 
-    auto start = std::chrono::high_resolution_clock::now();
-
+    // The work runs on the calling thread, pinned to the biggest core
+    pin_to_core(get_biggest_core());
     if (setpriority(PRIO_PROCESS, 0, -10) != 0) {
         LOGE("Failed to set thread priority");
     }
 
-    volatile double result = 0;
-    for (auto i = 0; i < total_iterations; i++) {
-        result += heavy_math(static_cast<double>(i));
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;
 
-        current_iterations_done.fetch_add(1, std::memory_order_relaxed);
+    // Work is handed out in slices so the callback overhead stays negligible next to the work itself
+    const long long slice = std::max(1LL, total_iterations / 10000);
+    for (long long i = 0; i < total_iterations; i += slice) {
+        long long slice_end = std::min(total_iterations, i + slice);
+        TRACE_SCOPE("cpu_slice", i / slice);
+        work(i, slice_end);
+
+        current_iterations_done.fetch_add(slice_end - i, std::memory_order_relaxed);
     }
+    perf.stop();
+    energy.stop();
 
     reporter_thread.join();
 
@@ -105,12 +123,11 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathSingleCoreBen
     env->DeleteGlobalRef(activity_class_global_ref);
 
     auto end = std::chrono::high_resolution_clock::now();
-    (void)result;
     return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 }
 
 jlong run_multicore_benchmark(
-        JNIEnv *env, jobject activity, long long total_iterations) {
+        JNIEnv *env, jobject activity, long long total_iterations, const CpuWorkFn& work) {
 
     if (total_iterations <= 0) return 0;
     if (activity == nullptr) return 0;
@@ -129,7 +146,9 @@ jlong run_multicore_benchmark(
     env->DeleteLocalRef(activity_class); // Added this line
     jmethodID update_progress_method_id = env->GetMethodID(activity_class_global_ref, "updateBenchmarkProgress", "(F)V");
 
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;    // workers are created inside the region and inherit the counters
 
     std::vector<std::thread> threads;
     threads.reserve(num_cores);
@@ -150,10 +169,9 @@ jlong run_multicore_benchmark(
                 long long task_start = task_index * task_size + std::min(task_index, remainder);
                 long long task_end = task_start + task_size + (task_index < remainder ? 1 : 0);
 
-                volatile double result_thread = 0;
-                for (auto i = task_start; i < task_end; ++i) {
-                    result_thread += heavy_math(static_cast<double>(i));
-                }
+                TraceScope trace("cpu_task", task_index);
+                work(task_start, task_end);
+                trace.end();
 
                 long long completed = completed_iterations.fetch_add(task_end - task_start,
                                                                      std::memory_order_relaxed) + (task_end - task_start);
@@ -169,6 +187,8 @@ jlong run_multicore_benchmark(
     }
 
     for (auto &th : threads) th.join();
+    perf.stop();
+    energy.stop();
 
     if (env && activity_global_ref && update_progress_method_id) {
         env->CallVoidMethod(activity_global_ref, update_progress_method_id, 1.0f);
@@ -180,12 +200,78 @@ jlong run_multicore_benchmark(
     return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 }
 
+// heavy_math on every given core in small chunks; the index wraps so every chunk costs the same
+class CpuMathLoad : public ContentionLoad {
+public:
+    const char* name() const override { return "cpu_math"; }
+    const char* unit() const override { return "iter_s"; }
+    int max_cores() const override { return 1 << 16; }
+    bool prepare() override { return true; }
+
+    double run(const std::vector<int>& cores, const std::atomic<bool>& stop) override {
+        const long long CHUNK = 4096, SPAN = 1LL << 24;
+        std::atomic<long long> done{0};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < cores.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                pin_to_core(cores[t]);
+                setpriority(PRIO_PROCESS, 0, -10);
+                TRACE_SCOPE("contention_cpu_math");
+                long long begin = static_cast<long long>(t) * SPAN / static_cast<long long>(cores.size());
+                while (!stop.load(std::memory_order_relaxed)) {
+                    heavy_math_range(begin, begin + CHUNK);
+                    begin = (begin + CHUNK) % SPAN;
+                    done.fetch_add(CHUNK, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        return static_cast<double>(done.load());
+    }
+};
+
+std::unique_ptr<ContentionLoad> make_cpu_math_load() {
+    return std::make_unique<CpuMathLoad>();
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathSingleCoreBenchmark(
+        JNIEnv *env, jobject thiz, jobject activity) {
+    (void)thiz;
+    const long long DEFAULT_ITERATIONS = 70000000LL;
+    long long iterations = size_work(DEFAULT_ITERATIONS);
+    jlong ms = run_singlecore_benchmark(env, activity, iterations, heavy_math_range);
+    const long long min_duration_iterations = work_for_min_duration(ms, iterations);
+    if (min_duration_iterations != iterations) {
+        iterations = min_duration_iterations;
+        ms = run_singlecore_benchmark(env, activity, iterations, heavy_math_range);
+    }
+    jlong full_ms = scale_to_full_work(ms, iterations, DEFAULT_ITERATIONS);
+    record_result(env, activity, BenchRecord("cpu_math_single", full_ms, "ms")
+            .metric("iterations_per_s", ms > 0 ? iterations * 1000.0 / ms : 0.0).metric("measured_ms", ms)
+            .param("iterations", iterations).param("threads", 1));
+    return full_ms;
+}
+
 JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuMathMultiCoreBenchmark(
         JNIEnv *env, jobject thiz, jobject activity) {
     (void)thiz;
     const long long DEFAULT_ITERATIONS = 70000000LL;
-    return run_multicore_benchmark(env, activity, DEFAULT_ITERATIONS);
+    long long iterations = size_work(DEFAULT_ITERATIONS);
+    jlong ms = run_multicore_benchmark(env, activity, iterations, heavy_math_range);
+    const long long min_duration_iterations = work_for_min_duration(ms, iterations);
+    if (min_duration_iterations != iterations) {
+        iterations = min_duration_iterations;
+        ms = run_multicore_benchmark(env, activity, iterations, heavy_math_range);
+    }
+    jlong full_ms = scale_to_full_work(ms, iterations, DEFAULT_ITERATIONS);
+    record_result(env, activity, BenchRecord("cpu_math_multi", full_ms, "ms")
+            .metric("iterations_per_s", ms > 0 ? iterations * 1000.0 / ms : 0.0).metric("measured_ms", ms)
+            .param("iterations", iterations).param("threads", std::max(1u, std::thread::hardware_concurrency())));
+    return full_ms;
 }
 
 void cpu_stress_task() {
@@ -0,0 +1,247 @@
+#include <jni.h>
+#include "openssl/bn.h"
+#include "openssl/curve25519.h"
+#include "openssl/ec_key.h"
+#include "openssl/ecdh.h"
+#include "openssl/ecdsa.h"
+#include "openssl/nid.h"
+#include "openssl/rsa.h"
+#include "openssl/sha.h"
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <sys/resource.h>
+#include "utils.h"
+#include "results.h"
+#include "perf_counters.h"
+#include "energy.h"
+
+// Asymmetric crypto throughput: the bignum / field arithmetic of TLS handshakes.
+// Every thread owns its keys (generated outside the timed region). Each operation runs as a separate
+// phase with a fixed total op count split across the threads, so ops/s is reported per operation
+// and the multi-core time shrinks with the number of performance cores.
+
+enum class PubkeyOp { ECDSA_P256_SIGN, ECDSA_P256_VERIFY, ED25519_SIGN, ED25519_VERIFY, X25519, ECDH_P256, RSA2048_SIGN, RSA2048_VERIFY };
+
+struct PubkeyOpInfo {
+    PubkeyOp op;
+    const char* name;
+    int total_ops;
+};
+
+static const PubkeyOpInfo PUBKEY_OPS[] = {
+        {PubkeyOp::ECDSA_P256_SIGN, "ECDSA P-256 sign", 20000},
+        {PubkeyOp::ECDSA_P256_VERIFY, "ECDSA P-256 verify", 8000},
+        {PubkeyOp::ED25519_SIGN, "Ed25519 sign", 20000},
+        {PubkeyOp::ED25519_VERIFY, "Ed25519 verify", 8000},
+        {PubkeyOp::X25519, "X25519", 10000},
+        {PubkeyOp::ECDH_P256, "ECDH P-256", 8000},
+        {PubkeyOp::RSA2048_SIGN, "RSA-2048 sign", 1000},
+        {PubkeyOp::RSA2048_VERIFY, "RSA-2048 verify", 40000},
+};
+
+static const size_t PUBKEY_OP_COUNT = sizeof(PUBKEY_OPS) / sizeof(PUBKEY_OPS[0]);
+
+struct PubkeyKeys {
+    EC_KEY* ec_key = nullptr;
+    EC_KEY* ec_peer = nullptr;
+    RSA* rsa = nullptr;
+    uint8_t ed_public[32]{}, ed_private[64]{}, ed_sig[64]{};
+    uint8_t x_public[32]{}, x_private[32]{}, x_peer_public[32]{}, x_peer_private[32]{};
+    uint8_t digest[SHA256_DIGEST_LENGTH]{};
+    std::vector<uint8_t> ecdsa_sig, rsa_sig;
+};
+
+static void pubkey_keys_free(PubkeyKeys& k) {
+    if (k.ec_key) EC_KEY_free(k.ec_key);
+    if (k.ec_peer) EC_KEY_free(k.ec_peer);
+    if (k.rsa) RSA_free(k.rsa);
+    k.ec_key = k.ec_peer = nullptr;
+    k.rsa = nullptr;
+}
+
+static bool pubkey_keys_init(PubkeyKeys& k) {
+    static const char message[] = "MaterialBench handshake transcript";
+    SHA256(reinterpret_cast<const uint8_t*>(message), sizeof(message) - 1, k.digest);
+
+    k.ec_key = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    k.ec_peer = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+    if (!k.ec_key || !k.ec_peer || !EC_KEY_generate_key(k.ec_key) || !EC_KEY_generate_key(k.ec_peer)) return false;
+
+    unsigned int sig_len = 0;
+    k.ecdsa_sig.resize(ECDSA_size(k.ec_key));
+    if (!ECDSA_sign(0, k.digest, sizeof(k.digest), k.ecdsa_sig.data(), &sig_len, k.ec_key)) return false;
+    k.ecdsa_sig.resize(sig_len);
+
+    ED25519_keypair(k.ed_public, k.ed_private);
+    if (!ED25519_sign(k.ed_sig, k.digest, sizeof(k.digest), k.ed_private)) return false;
+
+    X25519_keypair(k.x_public, k.x_private);
+    X25519_keypair(k.x_peer_public, k.x_peer_private);
+
+    BIGNUM* e = BN_new();
+    k.rsa = RSA_new();
+    bool rsa_ok = e && k.rsa && BN_set_word(e, RSA_F4) && RSA_generate_key_ex(k.rsa, 2048, e, nullptr);
+    if (e) BN_free(e);
+    if (!rsa_ok) return false;
+
+    k.rsa_sig.resize(RSA_size(k.rsa));
+    if (!RSA_sign(NID_sha256, k.digest, sizeof(k.digest), k.rsa_sig.data(), &sig_len, k.rsa)) return false;
+    k.rsa_sig.resize(sig_len);
+    return true;
+}
+
+static bool run_pubkey_op(PubkeyOp op, int count, PubkeyKeys& k) {
+    uint8_t out[512];
+    unsigned int out_len = 0;
+    for (int i = 0; i < count; ++i) {
+        bool ok = false;
+        switch (op) {
+            case PubkeyOp::ECDSA_P256_SIGN:
+                ok = ECDSA_sign(0, k.digest, sizeof(k.digest), out, &out_len, k.ec_key);
+                break;
+            case PubkeyOp::ECDSA_P256_VERIFY:
+                ok = ECDSA_verify(0, k.digest, sizeof(k.digest), k.ecdsa_sig.data(), k.ecdsa_sig.size(), k.ec_key) == 1;
+                break;
+            case PubkeyOp::ED25519_SIGN:
+                ok = ED25519_sign(out, k.digest, sizeof(k.digest), k.ed_private);
+                break;
+            case PubkeyOp::ED25519_VERIFY:
+                ok = ED25519_verify(k.digest, sizeof(k.digest), k.ed_sig, k.ed_public);
+                break;
+            case PubkeyOp::X25519:
+                ok = X25519(out, k.x_private, k.x_peer_public);
+                break;
+            case PubkeyOp::ECDH_P256:
+                ok = ECDH_compute_key(out, 32, EC_KEY_get0_public_key(k.ec_peer), k.ec_key, nullptr) == 32;
+                break;
+            case PubkeyOp::RSA2048_SIGN:
+                ok = RSA_sign(NID_sha256, k.digest, sizeof(k.digest), out, &out_len, k.rsa);
+                break;
+            case PubkeyOp::RSA2048_VERIFY:
+                ok = RSA_verify(NID_sha256, k.digest, sizeof(k.digest), k.rsa_sig.data(), k.rsa_sig.size(), k.rsa);
+                break;
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// Worker threads wait for the coordinator to publish the next phase, run it and report back
+struct PubkeyPhaseSync {
+    std::mutex mutex;
+    std::condition_variable cv;
+    int phase = -1;       // index into PUBKEY_OPS, PUBKEY_OP_COUNT = stop
+    int ready = 0;        // workers that finished key generation
+    int done = 0;         // workers that finished the current phase
+    std::atomic<bool> error{false};
+};
+
+static jlong run_pubkey_benchmark(JNIEnv* env, jobject activity, const char* test, const std::vector<int>& cores) {
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    const int num_threads = static_cast<int>(cores.size());
+    PubkeyPhaseSync sync;
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+
+    for (int t = 0; t < num_threads; ++t) {
+        int target_core = cores[t];
+        threads.emplace_back([&sync, target_core, num_threads]() {
+            pin_to_core(target_core);
+            setpriority(PRIO_PROCESS, 0, -10);
+
+            PubkeyKeys keys;
+            if (!pubkey_keys_init(keys)) sync.error = true;
+            PerfRegion perf;    // per worker, so key setup and thread start-up are not counted
+
+            std::unique_lock<std::mutex> lock(sync.mutex);
+            const int thread_index = sync.ready++;
+            sync.cv.notify_all();
+
+            int last_phase = -1;
+            while (true) {
+                sync.cv.wait(lock, [&] { return sync.phase != last_phase; });
+                last_phase = sync.phase;
+                if (last_phase >= static_cast<int>(PUBKEY_OP_COUNT)) break;
+
+                lock.unlock();
+                const auto& info = PUBKEY_OPS[last_phase];
+                int count = info.total_ops / num_threads + (thread_index < info.total_ops % num_threads ? 1 : 0);
+                if (!sync.error && !run_pubkey_op(info.op, count, keys)) {
+                    LOGE("Pubkey: %s failed", info.name);
+                    sync.error = true;
+                }
+                lock.lock();
+                sync.done++;
+                sync.cv.notify_all();
+            }
+            lock.unlock();
+            perf.stop();
+            pubkey_keys_free(keys);
+        });
+    }
+
+    double total_seconds = 0.0;
+    BenchRecord record(test, 0, "ms");
+    record.on_cores(cores);
+    {
+        std::unique_lock<std::mutex> lock(sync.mutex);
+        sync.cv.wait(lock, [&] { return sync.ready == num_threads; });
+
+        for (size_t p = 0; p < PUBKEY_OP_COUNT && !sync.error; ++p) {
+            sync.done = 0;
+            sync.phase = static_cast<int>(p);
+            EnergyRegion energy;
+            auto start = std::chrono::high_resolution_clock::now();
+            sync.cv.notify_all();
+            sync.cv.wait(lock, [&] { return sync.done == num_threads; });
+            auto end = std::chrono::high_resolution_clock::now();
+            energy.stop();
+
+            double seconds = std::chrono::duration<double>(end - start).count();
+            total_seconds += seconds;
+            if (seconds > 0) {
+                LOGI("Pubkey %-20s %d thread(s): %.0f ops/s", PUBKEY_OPS[p].name, num_threads,
+                     PUBKEY_OPS[p].total_ops / seconds);
+                record.metric(std::string(PUBKEY_OPS[p].name) + "_ops_per_s", PUBKEY_OPS[p].total_ops / seconds);
+            }
+
+            lock.unlock();
+            update_progress(env, activity, updateProgressMethod, static_cast<float>(p + 1) / PUBKEY_OP_COUNT);
+            lock.lock();
+        }
+
+        sync.phase = static_cast<int>(PUBKEY_OP_COUNT);
+        sync.cv.notify_all();
+    }
+
+    for (auto& th : threads) th.join();
+
+    if (sync.error) return -1;
+    record.result = static_cast<jlong>(total_seconds * 1000.0);
+    record_result(env, activity, record);
+    return record.result;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuPubkeySingleCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_pubkey_benchmark(env, activity, "cpu_pubkey_single", {get_biggest_core()});
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuPubkeyMultiCoreBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_pubkey_benchmark(env, activity, "cpu_pubkey_multi", get_performance_cores());
+}
+
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <jni.h>
+#include <functional>
+
+// Work callback for the shared CPU runners: process iterations [begin, end).
+using CpuWorkFn = std::function<void(long long begin, long long end)>;
+
+// Runs total_iterations of work on the calling thread, pinned to the biggest core, reporting progress
+// from an unpinned helper thread.
+jlong run_singlecore_benchmark(JNIEnv* env, jobject activity, long long total_iterations, const CpuWorkFn& work);
+
+// Splits total_iterations into tasks that every online core pulls from a shared counter.
+jlong run_multicore_benchmark(JNIEnv* env, jobject activity, long long total_iterations, const CpuWorkFn& work);
@@ -0,0 +1,352 @@
+#include <jni.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "utils.h"
+#include "topology.h"
+#include "results.h"
+#include "energy.h"
+#include <string>
+
+// Synchronization primitives under contention. Every primitive runs for a fixed time with 1..N threads
+// (N = online cores, filled from the strongest cluster down). Reported per point: total ops/s and
+// fairness (Jain's index over per-thread op counts, 1.0 = perfectly fair), recorded for every thread
+// count so the scaling curve is in the result record.
+// Lock-protected counters are checked against the op count afterwards.
+
+static const auto SYNC_POINT_DURATION = std::chrono::milliseconds(100);
+
+enum class SyncPrimitive { MUTEX, TICKET, MCS, SHARED_COUNTER, PADDED_COUNTER, RW_LOCK, FUTEX_HANDOFF };
+
+struct SyncPrimitiveInfo {
+    SyncPrimitive primitive;
+    const char* name;
+    const char* key;    // metric name prefix
+    bool scored;        // the padded counter is the uncontended baseline and stays out of the score
+};
+
+static const SyncPrimitiveInfo SYNC_PRIMITIVES[] = {
+        {SyncPrimitive::MUTEX, "std::mutex", "mutex", true},
+        {SyncPrimitive::TICKET, "ticket spinlock", "ticket", true},
+        {SyncPrimitive::MCS, "MCS lock", "mcs", true},
+        {SyncPrimitive::SHARED_COUNTER, "fetch_add shared", "shared_counter", true},
+        {SyncPrimitive::PADDED_COUNTER, "fetch_add padded", "padded_counter", false},
+        {SyncPrimitive::RW_LOCK, "shared_mutex 90% read", "rw_lock", true},
+        {SyncPrimitive::FUTEX_HANDOFF, "futex handoff", "futex_handoff", true},
+};
+
+static inline void sync_spin_pause(int& spins) {
+    // Back off to the scheduler if the holder is not running (more threads than cores)
+    if (++spins > 1000) {
+        std::this_thread::yield();
+        spins = 0;
+    }
+}
+
+// --- Ticket spinlock ---
+
+struct TicketLock {
+    alignas(64) std::atomic<uint32_t> next_ticket{0};
+    alignas(64) std::atomic<uint32_t> now_serving{0};
+
+    void lock() {
+        uint32_t ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+        int spins = 0;
+        while (now_serving.load(std::memory_order_acquire) != ticket) sync_spin_pause(spins);
+    }
+
+    void unlock() {
+        now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+// --- MCS queue lock: each waiter spins on its own node ---
+
+struct alignas(64) McsNode {
+    std::atomic<McsNode*> next{nullptr};
+    std::atomic<bool> locked{false};
+};
+
+struct McsLock {
+    alignas(64) std::atomic<McsNode*> tail{nullptr};
+
+    void lock(McsNode& node) {
+        node.next.store(nullptr, std::memory_order_relaxed);
+        node.locked.store(true, std::memory_order_relaxed);
+        McsNode* pred = tail.exchange(&node, std::memory_order_acq_rel);
+        if (!pred) return;
+        pred->next.store(&node, std::memory_order_release);
+        int spins = 0;
+        while (node.locked.load(std::memory_order_acquire)) sync_spin_pause(spins);
+    }
+
+    void unlock(McsNode& node) {
+        McsNode* succ = node.next.load(std::memory_order_acquire);
+        if (!succ) {
+            McsNode* expected = &node;
+            if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) return;
+            int spins = 0;
+            while (!(succ = node.next.load(std::memory_order_acquire))) sync_spin_pause(spins);
+        }
+        succ->locked.store(false, std::memory_order_release);
+    }
+};
+
+// --- Futex token ring: every thread sleeps on its own word until it holds the token, then hands it
+// to thread i + 1 by setting that thread's word and waking exactly that thread ---
+
+static const int FUTEX_TOKEN_STOP = -1;
+static const int FUTEX_TOKEN_WAIT = 0;
+static const int FUTEX_TOKEN_HELD = 1;
+
+static inline long futex_call(std::atomic<int>* addr, int op, int value) {
+    return syscall(SYS_futex, reinterpret_cast<int*>(addr), op, value, nullptr, nullptr, 0);
+}
+
+// --- Shared state for one measurement point ---
+
+struct alignas(64) SyncThreadSlot {
+    uint64_t ops = 0;
+    std::atomic<uint64_t> padded_counter{0};
+    std::atomic<int> futex_word{FUTEX_TOKEN_WAIT};
+    McsNode mcs_node;
+};
+
+struct SyncState {
+    std::atomic<bool> stop{false};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+
+    std::mutex mutex;
+    TicketLock ticket;
+    McsLock mcs;
+    std::shared_mutex rw_lock;
+    alignas(64) std::atomic<uint64_t> shared_counter{0};
+    alignas(64) uint64_t protected_counter = 0;
+    uint64_t rw_data[8] = {};
+    uint64_t rw_writes = 0;
+};
+
+static inline void sync_critical_section(SyncState& s) {
+    s.protected_counter++;
+}
+
+static void sync_worker(SyncState& s, SyncPrimitive primitive, int index, std::vector<SyncThreadSlot>& slots) {
+    const int threads = static_cast<int>(slots.size());
+    SyncThreadSlot& slot = slots[index];
+    uint64_t ops = 0;
+    uint32_t rng = 0x9E3779B9u * (index + 1);
+
+    s.ready.fetch_add(1);
+    while (!s.go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+    switch (primitive) {
+        case SyncPrimitive::MUTEX:
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                sync_critical_section(s);
+                ops++;
+            }
+            break;
+        case SyncPrimitive::TICKET:
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                s.ticket.lock();
+                sync_critical_section(s);
+                s.ticket.unlock();
+                ops++;
+            }
+            break;
+        case SyncPrimitive::MCS:
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                s.mcs.lock(slot.mcs_node);
+                sync_critical_section(s);
+                s.mcs.unlock(slot.mcs_node);
+                ops++;
+            }
+            break;
+        case SyncPrimitive::SHARED_COUNTER:
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                s.shared_counter.fetch_add(1, std::memory_order_relaxed);
+                ops++;
+            }
+            break;
+        case SyncPrimitive::PADDED_COUNTER:
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                slot.padded_counter.fetch_add(1, std::memory_order_relaxed);
+                ops++;
+            }
+            break;
+        case SyncPrimitive::RW_LOCK: {
+            volatile uint64_t sink = 0;
+            while (!s.stop.load(std::memory_order_relaxed)) {
+                rng = rng * 1664525u + 1013904223u;
+                if ((rng >> 16) % 10 == 0) {
+                    std::unique_lock<std::shared_mutex> lock(s.rw_lock);
+                    for (auto& v : s.rw_data) v++;
+                    s.rw_writes++;
+                } else {
+                    std::shared_lock<std::shared_mutex> lock(s.rw_lock);
+                    uint64_t sum = 0;
+                    for (auto v : s.rw_data) sum += v;
+                    sink = sum;
+                }
+                ops++;
+            }
+            (void)sink;
+            break;
+        }
+        case SyncPrimitive::FUTEX_HANDOFF: {
+            std::atomic<int>& next = slots[(index + 1) % threads].futex_word;
+            while (true) {
+                int word = slot.futex_word.load(std::memory_order_acquire);
+                if (word == FUTEX_TOKEN_STOP) break;
+                if (word == FUTEX_TOKEN_WAIT) {
+                    futex_call(&slot.futex_word, FUTEX_WAIT_PRIVATE, FUTEX_TOKEN_WAIT);
+                    continue;
+                }
+                ops++;
+                if (s.stop.load(std::memory_order_relaxed)) {
+                    // Only the token holder gets here, so nobody else writes the words meanwhile
+                    for (int t = 0; t < threads; ++t) {
+                        if (t == index) continue;
+                        slots[t].futex_word.store(FUTEX_TOKEN_STOP, std::memory_order_release);
+                        futex_call(&slots[t].futex_word, FUTEX_WAKE_PRIVATE, 1);
+                    }
+                    break;
+                }
+                if (threads == 1) continue;
+                slot.futex_word.store(FUTEX_TOKEN_WAIT, std::memory_order_relaxed);
+                next.store(FUTEX_TOKEN_HELD, std::memory_order_release);
+                futex_call(&next, FUTEX_WAKE_PRIVATE, 1);
+            }
+            break;
+        }
+    }
+    slot.ops = ops;
+}
+
+struct SyncPointResult {
+    double ops_per_sec = 0;
+    double fairness = 0;
+    bool valid = true;
+};
+
+static SyncPointResult run_sync_point(SyncPrimitive primitive, const std::vector<int>& cores, int threads) {
+    SyncState state;
+    std::vector<SyncThreadSlot> slots(threads);
+    slots[0].futex_word.store(FUTEX_TOKEN_HELD);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    for (int t = 0; t < threads; ++t) {
+        int core = cores[t % cores.size()];
+        workers.emplace_back([&, t, core]() {
+            pin_to_core(core);
+            setpriority(PRIO_PROCESS, 0, -10);
+            sync_worker(state, primitive, t, slots);
+        });
+    }
+
+    while (state.ready.load() < threads) std::this_thread::yield();
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    state.go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(SYNC_POINT_DURATION);
+    state.stop.store(true, std::memory_order_relaxed);
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
+
+    SyncPointResult result;
+    double total = 0, sum_sq = 0;
+    for (const auto& slot : slots) {
+        total += static_cast<double>(slot.ops);
+        sum_sq += static_cast<double>(slot.ops) * static_cast<double>(slot.ops);
+    }
+    result.ops_per_sec = total / std::chrono::duration<double>(end - start).count();
+    result.fairness = sum_sq > 0 ? total * total / (threads * sum_sq) : 0.0;
+
+    const auto total_ops = static_cast<uint64_t>(total);
+    switch (primitive) {
+        case SyncPrimitive::MUTEX:
+        case SyncPrimitive::TICKET:
+        case SyncPrimitive::MCS:
+            result.valid = state.protected_counter == total_ops;
+            break;
+        case SyncPrimitive::SHARED_COUNTER:
+            result.valid = state.shared_counter.load() == total_ops;
+            break;
+        case SyncPrimitive::RW_LOCK:
+            result.valid = std::all_of(std::begin(state.rw_data), std::end(state.rw_data),
+                                       [&](uint64_t v) { return v == state.rw_writes; });
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+extern "C" {
+
+// Returns the geometric mean of ns per operation at the highest thread count
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunCpuSyncContentionBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    // Strongest cluster first, so small thread counts land on the big cores
+    const CpuTopology& topo = get_cpu_topology();
+    std::vector<int> cores;
+    for (auto it = topo.clusters.rbegin(); it != topo.clusters.rend(); ++it) {
+        cores.insert(cores.end(), it->cpus.begin(), it->cpus.end());
+    }
+    if (cores.empty()) cores.push_back(0);
+    const int max_threads = static_cast<int>(cores.size());
+
+    const size_t primitive_count = sizeof(SYNC_PRIMITIVES) / sizeof(SYNC_PRIMITIVES[0]);
+    const size_t total_points = primitive_count * max_threads;
+    size_t point = 0;
+    double log_ns_sum = 0.0;
+    int scored = 0;
+    BenchRecord record("cpu_sync_contention", 0, "ns");
+    record.on_cores(cores).param("threads", max_threads).param("point_ms", SYNC_POINT_DURATION.count());
+
+    for (const auto& info : SYNC_PRIMITIVES) {
+        for (int threads = 1; threads <= max_threads; ++threads) {
+            SyncPointResult r = run_sync_point(info.primitive, cores, threads);
+            if (!r.valid) {
+                LOGE("Sync: %s with %d thread(s) lost updates", info.name, threads);
+                return -1;
+            }
+            LOGI("Sync %-22s %2d thread(s): %12.0f ops/s, fairness %.3f", info.name, threads, r.ops_per_sec, r.fairness);
+
+            const std::string prefix = std::string(info.key) + "_" + std::to_string(threads) + "t";
+            record.metric(prefix + "_ops_per_s", r.ops_per_sec).metric(prefix + "_fairness", r.fairness);
+            if (threads == max_threads && info.scored && r.ops_per_sec > 0) {
+                log_ns_sum += std::log(1e9 / r.ops_per_sec);
+                scored++;
+            }
+            update_progress(env, activity, updateProgressMethod, static_cast<float>(++point) / total_points);
+        }
+    }
+
+    if (scored == 0) return -1;
+    double ns_per_op = std::exp(log_ns_sum / scored);
+    LOGI("Sync geometric mean at %d thread(s): %.1f ns/op", max_threads, ns_per_op);
+    record.result = std::max<jlong>(1, static_cast<jlong>(ns_per_op + 0.5));
+    record_result(env, activity, record);
+    return record.result;
+}
+
+}
@@ -0,0 +1,272 @@
+#include "energy.h"
+#include "results.h"
+#include "topology.h"
+#include "utils.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+
+struct RaplDomain {
+    std::string energy_path;
+    unsigned long long max_range_uj = 0;
+    unsigned long long last_uj = 0;
+};
+
+struct EnergySources {
+    std::string battery_dir;            // power_supply node with current_now and voltage_now
+    std::vector<RaplDomain> rapl;       // package domains only, the subdomains are part of them
+};
+
+// Sampler state; the thread is joined when the process exits normally
+struct EnergySampler {
+    std::mutex mutex;
+    std::thread thread;
+    std::atomic<bool> stop{false};
+    EnergySources sources;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last_sample;
+    double last_watts = -1.0;
+    double joules = 0.0;
+    int samples = 0;
+    bool charging = false;
+    int open_regions = 0;           // EnergyRegion windows currently open
+    bool any_region = false;        // some region was opened during this test
+    double region_joules = 0.0;
+    double region_seconds = 0.0;
+
+    ~EnergySampler() {
+        stop = true;
+        if (thread.joinable()) thread.join();
+    }
+};
+
+static EnergySampler g_energy;
+
+static std::string read_line(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    if (f.is_open()) std::getline(f, line);
+    return line;
+}
+
+static bool read_value(const std::string& path, long long& value) {
+    std::ifstream f(path);
+    return static_cast<bool>(f >> value);
+}
+
+static EnergySources find_energy_sources() {
+    EnergySources sources;
+    if (DIR* dir = opendir("/sys/class/powercap")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            // intel-rapl:0 is a package, intel-rapl:0:1 one of its subdomains (AMD uses the same names)
+            if (name.rfind("intel-rapl:", 0) != 0 || name.find(':', 11) != std::string::npos) continue;
+            RaplDomain domain;
+            domain.energy_path = "/sys/class/powercap/" + name + "/energy_uj";
+            long long energy = 0, range = 0;
+            if (!read_value(domain.energy_path, energy)) continue;   // root only since the PLATYPUS fix
+            read_value("/sys/class/powercap/" + name + "/max_energy_range_uj", range);
+            domain.last_uj = static_cast<unsigned long long>(energy);
+            domain.max_range_uj = static_cast<unsigned long long>(range);
+            sources.rapl.push_back(domain);
+        }
+        closedir(dir);
+    }
+    if (!sources.rapl.empty()) return sources;
+
+    if (DIR* dir = opendir("/sys/class/power_supply")) {
+        while (dirent* entry = readdir(dir)) {
+            std::string path = std::string("/sys/class/power_supply/") + entry->d_name;
+            long long current = 0, voltage = 0;
+            if (read_line(path + "/type") != "Battery") continue;
+            if (!read_value(path + "/current_now", current) || !read_value(path + "/voltage_now", voltage)) continue;
+            sources.battery_dir = path;
+            break;
+        }
+        closedir(dir);
+    }
+    return sources;
+}
+
+// One sample under the sampler mutex: trapezoid rule on the battery power, counter deltas for RAPL.
+// The interval since the previous sample also counts as timed if a region is open.
+static void take_energy_sample() {
+    auto now = std::chrono::steady_clock::now();
+    double added = 0.0;
+    if (!g_energy.sources.rapl.empty()) {
+        for (auto& domain : g_energy.sources.rapl) {
+            long long energy = 0;
+            if (!read_value(domain.energy_path, energy)) continue;
+            auto value = static_cast<unsigned long long>(energy);
+            unsigned long long delta = value >= domain.last_uj ? value - domain.last_uj : value + domain.max_range_uj - domain.last_uj;
+            domain.last_uj = value;
+            added += delta / 1e6;
+        }
+    } else {
+        long long current_ua = 0, voltage_uv = 0;
+        if (!read_value(g_energy.sources.battery_dir + "/current_now", current_ua) ||
+            !read_value(g_energy.sources.battery_dir + "/voltage_now", voltage_uv)) return;
+        // The sign of current_now differs between vendors; only its magnitude is used
+        const double watts = std::fabs(static_cast<double>(current_ua)) * 1e-6 * voltage_uv * 1e-6;
+        if (g_energy.last_watts >= 0) {
+            const double dt = std::chrono::duration<double>(now - g_energy.last_sample).count();
+            added = 0.5 * (watts + g_energy.last_watts) * dt;
+        }
+        g_energy.last_watts = watts;
+    }
+    g_energy.joules += added;
+    if (g_energy.open_regions > 0 && g_energy.samples > 0) {
+        g_energy.region_joules += added;
+        g_energy.region_seconds += std::chrono::duration<double>(now - g_energy.last_sample).count();
+    }
+    g_energy.last_sample = now;
+    ++g_energy.samples;
+}
+
+static void energy_sampler_task() {
+    const CpuTopology& topo = get_cpu_topology();
+    if (!topo.clusters.empty() && !topo.clusters.front().cpus.empty()) pin_to_core(topo.clusters.front().cpus.front());
+    while (!g_energy.stop.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(g_energy.mutex);
+            take_energy_sample();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(ENERGY_SAMPLE_MS));
+    }
+}
+
+void energy_begin_test() {
+    static std::once_flag detected;
+    std::call_once(detected, []() {
+        g_energy.sources = find_energy_sources();
+        if (!g_energy.sources.rapl.empty()) {
+            LOGI("Energy: %zu RAPL package domain(s)", g_energy.sources.rapl.size());
+        } else if (!g_energy.sources.battery_dir.empty()) {
+            LOGI("Energy: battery gauge %s", g_energy.sources.battery_dir.c_str());
+        } else {
+            LOGW("Energy: no readable battery gauge or RAPL counters, energy is not reported");
+        }
+    });
+    if (g_energy.sources.rapl.empty() && g_energy.sources.battery_dir.empty()) return;
+
+    const std::string status = g_energy.sources.battery_dir.empty() ? "" : read_line(g_energy.sources.battery_dir + "/status");
+    std::lock_guard<std::mutex> lock(g_energy.mutex);
+    g_energy.joules = 0.0;
+    g_energy.samples = 0;
+    g_energy.last_watts = -1.0;
+    g_energy.open_regions = 0;
+    g_energy.any_region = false;
+    g_energy.region_joules = 0.0;
+    g_energy.region_seconds = 0.0;
+    g_energy.charging = status == "Charging" || status == "Full";
+    if (g_energy.charging) LOGW("Energy: the device is charging, battery power readings include the charger");
+    take_energy_sample();   // baseline: first battery power, current RAPL counters
+    g_energy.joules = 0.0;
+    g_energy.start = g_energy.last_sample;
+    if (!g_energy.thread.joinable()) {
+        g_energy.stop = false;
+        g_energy.thread = std::thread(energy_sampler_task);
+    }
+}
+
+void energy_end_run() {
+    g_energy.stop = true;
+    if (g_energy.thread.joinable()) g_energy.thread.join();
+}
+
+static bool energy_available() {
+    return !g_energy.sources.rapl.empty() || !g_energy.sources.battery_dir.empty();
+}
+
+// The boundary samples read sysfs, so regions are best opened before the clock starts
+EnergyRegion::EnergyRegion() {
+    std::lock_guard<std::mutex> lock(g_energy.mutex);
+    if (!energy_available() || g_energy.samples == 0) return;
+    take_energy_sample();
+    ++g_energy.open_regions;
+    g_energy.any_region = true;
+    running_ = true;
+}
+
+EnergyRegion::~EnergyRegion() {
+    stop();
+}
+
+void EnergyRegion::stop() {
+    if (!running_) return;
+    running_ = false;
+    std::lock_guard<std::mutex> lock(g_energy.mutex);
+    if (g_energy.open_regions == 0) return;     // the test was restarted meanwhile
+    take_energy_sample();
+    --g_energy.open_regions;
+}
+
+EnergyReading energy_read() {
+    EnergyReading reading;
+    std::lock_guard<std::mutex> lock(g_energy.mutex);
+    if (g_energy.samples < 2) return reading;
+    if (g_energy.any_region && g_energy.region_seconds <= 0) return reading;
+    reading.valid = true;
+    reading.source = g_energy.sources.rapl.empty() ? "battery" : "rapl";
+    reading.timed = g_energy.any_region;
+    reading.seconds = reading.timed ? g_energy.region_seconds
+                                    : std::chrono::duration<double>(g_energy.last_sample - g_energy.start).count();
+    reading.joules = reading.timed ? g_energy.region_joules : g_energy.joules;
+    reading.samples = g_energy.samples;
+    reading.charging = g_energy.charging;
+    return reading;
+}
+
+std::string EnergyReading::to_json() const {
+    if (!valid) return "null";
+    char buf[288];
+    snprintf(buf, sizeof(buf),
+             "{\"source\":\"%s\",\"window\":\"%s\",\"seconds\":%.3f,\"joules\":%.4f,\"average_watts\":%.4f,"
+             "\"samples\":%d,\"charging\":%s}",
+             source, timed ? "timed" : "test", seconds, joules, average_watts(), samples, charging ? "true" : "false");
+    return buf;
+}
+
+static bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void attach_energy_metrics(BenchRecord& record, const EnergyReading& energy) {
+    const double watts = energy.average_watts();
+    if (!energy.valid || watts <= 0) return;
+
+    std::vector<std::pair<std::string, double>> efficiency;
+    for (const auto& metric : record.metrics) {
+        const std::string& name = metric.first;
+        if (ends_with(name, "_per_s")) {
+            efficiency.emplace_back(name.substr(0, name.size() - 2) + "_j", metric.second / watts);
+        } else if (ends_with(name, "_s")) {
+            efficiency.emplace_back(name.substr(0, name.size() - 2) + "_per_j", metric.second / watts);
+        } else if (ends_with(name, "gflops")) {
+            efficiency.emplace_back(name + "_per_w", metric.second / watts);
+        }
+    }
+    LOGI("Energy %s: %.2f J over %.2f s (%s), %.2f W average (%s)", record.test.c_str(), energy.joules, energy.seconds,
+         energy.timed ? "timed" : "whole test", watts, energy.source);
+
+    // Score-level figure, present in every record
+    double work_per_j = 0.0;
+    if (record.result > 0) {
+        const double result = static_cast<double>(record.result);
+        if (record.result_unit == "ms") work_per_j = 1e3 / (result * watts);
+        else if (record.result_unit == "us") work_per_j = 1e6 / (result * watts);
+        else if (record.result_unit == "ns") work_per_j = 1e9 / (result * watts);
+        else if (ends_with(record.result_unit, "_per_s")) work_per_j = result / watts;
+    }
+    if (work_per_j > 0) record.metric("work_per_j", work_per_j);
+
+    if (efficiency.size() > ENERGY_MAX_EFFICIENCY_METRICS) return;
+    for (const auto& metric : efficiency) record.metric(metric.first, metric.second);
+}
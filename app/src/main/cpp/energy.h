@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+struct BenchRecord;
+
+// Energy drawn during the current test. A sampler thread on the weakest core reads the battery's
+// current_now and voltage_now every ENERGY_SAMPLE_MS and integrates the power, or, on Linux hosts
+// with RAPL, accumulates the package energy_uj counters. The battery gauge measures the whole
+// device (screen included) and usually updates slower than the sampler, so short tests are coarse;
+// while charging it measures the net flow and the reading is flagged.
+// Tests mark their scored work with EnergyRegion, next to PerfRegion; the reading then covers only
+// those windows, so untimed setup (file creation, corpus building, warm-up) is left out. Tests
+// without a region fall back to the whole span from nativeBeginTestAccounting to the record.
+
+static const int ENERGY_SAMPLE_MS = 20;
+static const size_t ENERGY_MAX_EFFICIENCY_METRICS = 8;   // sweeps share one average power, so skip them
+
+struct EnergyReading {
+    bool valid = false;
+    const char* source = "none";    // "battery" or "rapl"
+    double seconds = 0.0;
+    double joules = 0.0;
+    int samples = 0;
+    bool charging = false;
+    bool timed = false;             // from EnergyRegion windows, not the whole test
+
+    double average_watts() const { return seconds > 0 ? joules / seconds : 0.0; }
+    std::string to_json() const;
+};
+
+// Restarts the integration for a new test; starts the sampler on first use
+void energy_begin_test();
+
+// Scoped timed window; regions may nest and overlap across threads, the reading covers their union
+class EnergyRegion {
+public:
+    EnergyRegion();
+    ~EnergyRegion();            // stop() if still running
+    EnergyRegion(const EnergyRegion&) = delete;
+    EnergyRegion& operator=(const EnergyRegion&) = delete;
+
+    void stop();
+
+private:
+    bool running_ = false;
+};
+
+// Stops the sampler at the end of a run
+void energy_end_run();
+EnergyReading energy_read();
+
+// Adds work per joule to record: always work_per_j for the result itself (full runs per joule for ms
+// results, operations per joule for ns and us, the rate per watt for x_per_s), plus, for records with
+// few throughput metrics, x_per_s -> x_per_j, x_gb_s -> x_gb_per_j, gflops -> gflops_per_w
+void attach_energy_metrics(BenchRecord& record, const EnergyReading& energy);
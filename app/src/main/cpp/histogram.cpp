@@ -0,0 +1,65 @@
+#include "histogram.h"
+#include <algorithm>
+#include <cmath>
+#include "utils.h"
+
+static inline size_t bucket_index(uint64_t v) {
+    if (v < LatencyHistogram::SUB_BUCKET_COUNT) return static_cast<size_t>(v);
+    int highest_bit = 63 - __builtin_clzll(v);
+    int shift = highest_bit - LatencyHistogram::SUB_BUCKET_BITS;
+    auto sub = static_cast<size_t>((v >> shift) - LatencyHistogram::SUB_BUCKET_COUNT);
+    return size_t(shift + 1) * LatencyHistogram::SUB_BUCKET_COUNT + sub;
+}
+
+static inline uint64_t bucket_upper_bound(size_t index) {
+    size_t magnitude = index / LatencyHistogram::SUB_BUCKET_COUNT;
+    uint64_t sub = index % LatencyHistogram::SUB_BUCKET_COUNT;
+    if (magnitude == 0) return sub;
+    int shift = static_cast<int>(magnitude) - 1;
+    return ((sub + LatencyHistogram::SUB_BUCKET_COUNT + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    counts[bucket_index(ns)]++;
+    total++;
+    sum_ns += ns;
+    if (ns < min_ns) min_ns = ns;
+    if (ns > max_ns) max_ns = ns;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    total += other.total;
+    sum_ns += other.sum_ns;
+    min_ns = std::min(min_ns, other.min_ns);
+    max_ns = std::max(max_ns, other.max_ns);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum_ns = 0;
+    min_ns = UINT64_MAX;
+    max_ns = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0;
+    p = std::min(100.0, std::max(0.0, p));
+    auto rank = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total)));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(bucket_upper_bound(i), max_ns);
+    }
+    return max_ns;
+}
+
+void log_latency_histogram(const char* label, const LatencyHistogram& h) {
+    LOGI("%s: n=%llu mean=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+         label, (unsigned long long)h.total, h.mean() / 1000.0,
+         h.percentile(50.0) / 1000.0, h.percentile(90.0) / 1000.0,
+         h.percentile(99.0) / 1000.0, h.percentile(99.9) / 1000.0,
+         h.max_ns / 1000.0);
+}
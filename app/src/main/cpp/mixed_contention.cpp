@@ -0,0 +1,183 @@
+#include <jni.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils.h"
+#include "results.h"
+#include "energy.h"
+#include "trace.h"
+#include "sizing.h"
+#include "topology.h"
+#include "contention.h"
+
+// Mixed-subsystem contention. The CPU math, RAM read bandwidth, storage random I/O and Vulkan GEMM
+// loads run on disjoint cores, first each one alone, then every pair, then all of them at once.
+// Every load's throughput in a shared phase is divided by its isolated throughput, which gives the
+// interference matrix: cpu_math_with_ram_read_rel = 0.8 means the RAM load cost the CPU load 20%.
+// The result is the time a CONTENTION_PHASE_MS isolated mix takes with everything running, i.e. the
+// phase length divided by the geometric mean of the all-at-once ratios.
+
+static const long long CONTENTION_PHASE_MS = 3000;
+static const long long CONTENTION_MIN_PHASE_MS = 1000;
+
+struct ContentionPhase {
+    std::vector<size_t> loads;      // indices into the load list
+    std::vector<double> rates;      // units per second, same order as loads
+};
+
+// The light loads (GPU submission, storage) take the weakest cores, RAM the next ones and CPU math
+// everything that is left, so the strongest cores do the compute. With too few cores the remaining
+// loads share the strongest one and disjoint is cleared.
+static std::vector<std::vector<int>> assign_cores(const std::vector<std::unique_ptr<ContentionLoad>>& loads,
+                                                  bool& disjoint) {
+    std::vector<int> order;
+    for (const auto& cluster : get_cpu_topology().clusters) order.insert(order.end(), cluster.cpus.begin(), cluster.cpus.end());
+    if (order.empty()) order.push_back(get_biggest_core());
+
+    std::vector<std::vector<int>> cores(loads.size());
+    disjoint = true;
+    size_t next = 0;
+    for (size_t i = loads.size(); i-- > 0;) {
+        const size_t left = order.size() - next;
+        const size_t take = i == 0 ? left : std::min<size_t>(loads[i]->max_cores(), left > i ? left - i : 0);
+        if (take == 0) {
+            cores[i].push_back(order.back());
+            disjoint = false;
+            continue;
+        }
+        cores[i].assign(order.begin() + next, order.begin() + next + take);
+        next += take;
+    }
+    return cores;
+}
+
+static std::string core_list(const std::vector<int>& cores) {
+    std::string text;
+    for (int core : cores) text += (text.empty() ? "" : ",") + std::to_string(core);
+    return text;
+}
+
+// Runs the given loads together for phase_ms and returns their rates
+static std::vector<double> run_phase(const std::vector<std::unique_ptr<ContentionLoad>>& loads,
+                                     const std::vector<std::vector<int>>& cores,
+                                     const std::vector<size_t>& active, long long phase_ms) {
+    std::atomic<bool> stop{false};
+    std::vector<double> units(active.size(), 0.0);
+    std::vector<std::thread> threads;
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t a = 0; a < active.size(); ++a) {
+        threads.emplace_back([&, a]() { units[a] = loads[active[a]]->run(cores[active[a]], stop); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(phase_ms));
+    stop.store(true);
+    for (auto& th : threads) th.join();
+    energy.stop();
+    const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::vector<double> rates;
+    for (double u : units) rates.push_back(seconds > 0 ? u / seconds : 0.0);
+    return rates;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunMixedContentionBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    const long long phase_ms = size_work(CONTENTION_PHASE_MS, CONTENTION_MIN_PHASE_MS);
+    const std::string filesDir = get_files_dir_path(env, activity);
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    std::vector<std::unique_ptr<ContentionLoad>> candidates;
+    candidates.push_back(make_cpu_math_load());
+    candidates.push_back(make_ram_bandwidth_load());
+    candidates.push_back(make_rom_random_load(filesDir));
+    candidates.push_back(make_gpu_gemm_load());
+
+    std::vector<std::unique_ptr<ContentionLoad>> loads;
+    TraceScope prepare_trace("contention_prepare");
+    for (auto& load : candidates) {
+        if (load->prepare()) {
+            loads.push_back(std::move(load));
+        } else {
+            LOGW("Contention: %s is unavailable and left out", load->name());
+        }
+    }
+    prepare_trace.end();
+    if (loads.size() < 2) return -1;
+
+    bool disjoint = true;
+    const auto cores = assign_cores(loads, disjoint);
+    for (size_t i = 0; i < loads.size(); ++i) {
+        LOGI("Contention: %s on cores %s", loads[i]->name(), core_list(cores[i]).c_str());
+    }
+    if (!disjoint) LOGW("Contention: not enough cores, some loads share a core");
+
+    std::vector<ContentionPhase> phases;
+    for (size_t i = 0; i < loads.size(); ++i) phases.push_back({{i}, {}});
+    for (size_t i = 0; i < loads.size(); ++i) {
+        for (size_t j = i + 1; j < loads.size(); ++j) phases.push_back({{i, j}, {}});
+    }
+    // With two loads the only pair already runs everything, so it doubles as the all-at-once phase
+    if (loads.size() > 2) {
+        std::vector<size_t> all(loads.size());
+        for (size_t i = 0; i < loads.size(); ++i) all[i] = i;
+        phases.push_back({all, {}});
+    }
+
+    for (size_t p = 0; p < phases.size(); ++p) {
+        TRACE_SCOPE("contention_phase", static_cast<int64_t>(p));
+        phases[p].rates = run_phase(loads, cores, phases[p].loads, phase_ms);
+        update_progress(env, activity, updateProgressMethod, static_cast<float>(p + 1) / phases.size());
+    }
+
+    std::vector<int> used;
+    for (const auto& c : cores) used.insert(used.end(), c.begin(), c.end());
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+
+    BenchRecord record("mixed_contention", 0, "ms");
+    record.on_cores(used).param("phase_ms", phase_ms).param("loads", loads.size()).param("disjoint", disjoint ? 1 : 0);
+
+    std::vector<double> isolated(loads.size());
+    for (size_t i = 0; i < loads.size(); ++i) {
+        isolated[i] = phases[i].rates[0];
+        record.metric(std::string(loads[i]->name()) + "_" + loads[i]->unit(), isolated[i])
+              .param(std::string(loads[i]->name()) + "_cores", cores[i].size());
+    }
+
+    double log_sum = 0.0;
+    for (size_t p = loads.size(); p < phases.size(); ++p) {
+        const auto& phase = phases[p];
+        const bool pair = phase.loads.size() == 2;
+        const bool together = phase.loads.size() == loads.size();
+        for (size_t a = 0; a < phase.loads.size(); ++a) {
+            const size_t victim = phase.loads[a];
+            const double rel = isolated[victim] > 0 ? phase.rates[a] / isolated[victim] : 0.0;
+            const std::string aggressor = pair ? loads[phase.loads[1 - a]]->name() : "all";
+            record.metric(std::string(loads[victim]->name()) + "_with_" + aggressor + "_rel", rel);
+            if (together) {
+                record.metric(std::string(loads[victim]->name()) + "_all_" + loads[victim]->unit(), phase.rates[a]);
+                log_sum += std::log(std::max(rel, 1e-3));
+            }
+            LOGI("Contention: %-10s with %-10s %6.1f%% of isolated", loads[victim]->name(), aggressor.c_str(), rel * 100.0);
+        }
+    }
+
+    const double geomean = std::exp(log_sum / loads.size());
+    record.result = static_cast<jlong>(CONTENTION_PHASE_MS / geomean);
+    record.metric("geomean_rel_all", geomean);
+    record_result(env, activity, record);
+    return record.result;
+}
+
+}
@@ -0,0 +1,149 @@
+#include "perf_counters.h"
+#include "results.h"
+#include "utils.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct PerfCounterInfo {
+    uint32_t type;
+    uint64_t config;
+    const char* name;
+};
+
+static const PerfCounterInfo PERF_COUNTERS[PERF_COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, "cache_references"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache_misses"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch_misses"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, "stalled_frontend"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND, "stalled_backend"},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task_clock_ns"},
+};
+
+static std::mutex g_perf_mutex;
+static PerfSample g_pending_sample;
+static std::atomic<bool> g_perf_denied_logged{false};
+
+void PerfSample::add(const PerfSample& other) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (!other.valid[i]) continue;
+        values[i] += other.values[i];
+        valid[i] = true;
+    }
+    multiplexed = multiplexed || other.multiplexed;
+}
+
+bool PerfSample::empty() const {
+    for (bool v : valid) {
+        if (v) return false;
+    }
+    return true;
+}
+
+// Counters are opened one by one rather than as a group: grouped reads are not supported together
+// with inherit, and a PMU without stall events should not cost the other counters
+static int open_counter(const PerfCounterInfo& info) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = info.type;
+    attr.config = info.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;    // user space only, allowed up to perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.disabled = 1;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfRegion::PerfRegion() {
+    for (int& fd : fds_) fd = -1;
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        fds_[i] = open_counter(PERF_COUNTERS[i]);
+        if (fds_[i] < 0 && i == PERF_CYCLES) {
+            if (!g_perf_denied_logged.exchange(true)) {
+                LOGW("Perf counters unavailable (errno %d: %s); results carry no counter metrics",
+                     errno, strerror(errno));
+            }
+            return;
+        }
+    }
+    for (int fd : fds_) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    running_ = true;
+}
+
+PerfRegion::~PerfRegion() {
+    stop();
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+}
+
+void PerfRegion::stop() {
+    if (!running_) return;
+    running_ = false;
+
+    PerfSample sample;
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (fds_[i] < 0) continue;
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t data[3] = {};  // value, time enabled, time running
+        if (read(fds_[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[2] > 0) {
+            sample.values[i] = data[0];
+            if (data[2] < data[1]) {
+                sample.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+                sample.multiplexed = true;
+            }
+            sample.valid[i] = true;
+        }
+        close(fds_[i]);
+        fds_[i] = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(g_perf_mutex);
+    g_pending_sample.add(sample);
+}
+
+void attach_perf_metrics(BenchRecord& record) {
+    PerfSample s;
+    {
+        std::lock_guard<std::mutex> lock(g_perf_mutex);
+        s = g_pending_sample;
+        g_pending_sample = PerfSample{};
+    }
+    if (s.empty()) return;
+
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) {
+        if (s.valid[i]) record.metric(std::string("perf_") + PERF_COUNTERS[i].name, static_cast<double>(s.values[i]));
+    }
+    const double cycles = static_cast<double>(s.values[PERF_CYCLES]);
+    const double kilo_instructions = s.values[PERF_INSTRUCTIONS] / 1000.0;
+    double ipc = 0.0, ghz = 0.0, cache_mpki = 0.0, branch_mpki = 0.0;
+    if (s.valid[PERF_CYCLES] && s.valid[PERF_INSTRUCTIONS] && cycles > 0) {
+        ipc = s.values[PERF_INSTRUCTIONS] / cycles;
+        record.metric("ipc", ipc);
+    }
+    if (s.valid[PERF_INSTRUCTIONS] && kilo_instructions > 0) {
+        if (s.valid[PERF_CACHE_MISSES]) record.metric("cache_mpki", cache_mpki = s.values[PERF_CACHE_MISSES] / kilo_instructions);
+        if (s.valid[PERF_BRANCH_MISSES]) record.metric("branch_mpki", branch_mpki = s.values[PERF_BRANCH_MISSES] / kilo_instructions);
+    }
+    if (s.valid[PERF_CYCLES] && s.valid[PERF_TASK_CLOCK] && s.values[PERF_TASK_CLOCK] > 0) {
+        ghz = cycles / s.values[PERF_TASK_CLOCK];
+        record.metric("effective_ghz", ghz);
+    }
+    if (cycles > 0) {
+        if (s.valid[PERF_STALLED_FRONTEND]) record.metric("frontend_stall_pct", 100.0 * s.values[PERF_STALLED_FRONTEND] / cycles);
+        if (s.valid[PERF_STALLED_BACKEND]) record.metric("backend_stall_pct", 100.0 * s.values[PERF_STALLED_BACKEND] / cycles);
+    }
+    record.param("perf_multiplexed", s.multiplexed ? 1 : 0);
+    LOGI("Perf %s: IPC %.2f, %.2f GHz effective, cache MPKI %.2f, branch MPKI %.2f%s", record.test.c_str(),
+         ipc, ghz, cache_mpki, branch_mpki, s.multiplexed ? " (multiplexed)" : "");
+}
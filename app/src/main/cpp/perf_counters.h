@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+
+struct BenchRecord;
+
+// Hardware counters around a timed region, opened with perf_event_open for the calling thread and
+// inherited by every thread it creates while the region is open (worker threads are summed into
+// the parent when they exit, so they must be joined before stop()).
+// Apps are usually denied counters (perf_event_paranoid / security.perf_harden); the region then
+// records nothing and the test runs unchanged. `adb shell setprop security.perf_harden 0` enables them
+// on userdebug builds.
+
+enum PerfCounterId {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_REFERENCES,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_STALLED_FRONTEND,
+    PERF_STALLED_BACKEND,
+    PERF_TASK_CLOCK,        // ns of CPU time, the base for effective GHz
+    PERF_COUNTER_COUNT
+};
+
+struct PerfSample {
+    uint64_t values[PERF_COUNTER_COUNT] = {};
+    bool valid[PERF_COUNTER_COUNT] = {};
+    bool multiplexed = false;   // some counter did not run the whole time and was scaled
+
+    void add(const PerfSample& other);
+    bool empty() const;
+};
+
+class PerfRegion {
+public:
+    PerfRegion();               // opens and starts the counters
+    ~PerfRegion();              // stop() if still running
+    PerfRegion(const PerfRegion&) = delete;
+    PerfRegion& operator=(const PerfRegion&) = delete;
+
+    // Reads and closes the counters and adds them to the pending sample for the next record
+    void stop();
+
+private:
+    int fds_[PERF_COUNTER_COUNT];
+    bool running_ = false;
+};
+
+// Moves the counters accumulated since the last record into record as ipc, mpki, ghz and raw counts
+void attach_perf_metrics(BenchRecord& record);
@@ -0,0 +1,221 @@
+#include "preflight.h"
+#include "utils.h"
+#include "topology.h"
+#include "sizing.h"
+#include "trace.h"
+#include <jni.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <dirent.h>
+
+static std::mutex g_preflight_mutex;
+static PreflightResult g_last_preflight;
+static double g_run_temp_limit_c = PREFLIGHT_MAX_TEMP_C;
+static std::vector<std::pair<int, long>> g_run_max_freq;    // scaling_max_freq of every core at run start
+static bool g_run_baseline_pending = false;
+static bool g_run_start_cool = true;
+
+struct CpuTimes {
+    unsigned long long busy = 0;
+    unsigned long long total = 0;
+    bool valid = false;
+};
+
+// Aggregate "cpu" line of /proc/stat; iowait counts as idle
+static CpuTimes read_cpu_times() {
+    CpuTimes times;
+    std::ifstream f("/proc/stat");
+    std::string label;
+    if (!(f >> label) || label != "cpu") return times;
+    unsigned long long v[8] = {};
+    for (auto& value : v) f >> value;
+    if (!f) return times;
+    const unsigned long long idle = v[3] + v[4];
+    for (auto value : v) times.total += value;
+    times.busy = times.total - idle;
+    times.valid = times.total > 0;
+    return times;
+}
+
+static double read_loadavg() {
+    std::ifstream f("/proc/loadavg");
+    double load = -1.0;
+    if (!(f >> load)) return -1.0;
+    return load;
+}
+
+// Hottest zone in degrees Celsius; values outside 0..150 C are bogus sensors and ignored
+static double read_max_temp_c() {
+    double max_temp = -1.0;
+    DIR* dir = opendir("/sys/class/thermal");
+    if (!dir) return max_temp;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.rfind("thermal_zone", 0) != 0) continue;
+        std::ifstream f("/sys/class/thermal/" + name + "/temp");
+        long long milli = 0;
+        if (!(f >> milli)) continue;
+        double temp = milli / 1000.0;
+        if (temp > 0.0 && temp < 150.0) max_temp = std::max(max_temp, temp);
+    }
+    closedir(dir);
+    return max_temp;
+}
+
+static long read_long(const std::string& path) {
+    std::ifstream f(path);
+    long value = 0;
+    return (f >> value) ? value : 0;
+}
+
+static long read_scaling_max_freq(int cpu) {
+    return read_long("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_max_freq");
+}
+
+// Thermal mitigation lowers scaling_max_freq; only caps added since run start count, since many vendor
+// power policies keep some clusters below cpuinfo_max_freq permanently
+static int count_capped_cores(const std::vector<std::pair<int, long>>& run_max_freq) {
+    int capped = 0;
+    for (const auto& core : run_max_freq) {
+        long max = read_scaling_max_freq(core.first);
+        if (core.second > 0 && max > 0 && max < core.second) ++capped;
+    }
+    return capped;
+}
+
+// Noise score: busy % of the other processes, plus 5 per degree above the limit, plus 10 per capped
+// core, plus 25 if the system never settled; 0 is a quiet, cool device
+static double noise_score(const PreflightResult& r) {
+    double score = std::max(0.0, r.busy_pct);
+    if (r.max_temp_c > r.temp_limit_c) score += 5.0 * (r.max_temp_c - r.temp_limit_c);
+    score += 10.0 * r.capped_cores;
+    if (!r.quiescent) score += 25.0;
+    return score;
+}
+
+void preflight_begin_run() {
+    std::lock_guard<std::mutex> lock(g_preflight_mutex);
+    g_run_baseline_pending = true;
+    g_last_preflight = PreflightResult{};
+}
+
+// First pre-flight of a run: waits until the hottest zone is at most PREFLIGHT_MAX_TEMP_C, so heat left
+// over from a stress test or an earlier run cannot raise the limit, then takes the temperature and
+// frequency-cap baselines. If the device never cools down the run goes on with a limit relative to the
+// current temperature and every result is flagged.
+static void take_run_baseline(int timeout_ms) {
+    TRACE_SCOPE("preflight_cooldown");
+    auto start = std::chrono::steady_clock::now();
+    double temp = read_max_temp_c();
+    int waited_ms = 0;
+    while (temp > PREFLIGHT_MAX_TEMP_C && waited_ms < timeout_ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(PREFLIGHT_SAMPLE_MS));
+        temp = read_max_temp_c();
+        waited_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count());
+    }
+    const bool cool = temp <= PREFLIGHT_MAX_TEMP_C;
+    if (!cool) {
+        LOGW("Preflight: still %.1f C after %d ms of cooldown, the run starts hot", temp, waited_ms);
+    }
+
+    std::vector<std::pair<int, long>> max_freq;
+    int below_hw_max = 0;
+    for (int cpu : get_cpu_topology().online) {
+        long max = read_scaling_max_freq(cpu);
+        long hw_max = read_long("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq");
+        if (hw_max > 0 && max > 0 && max < hw_max) ++below_hw_max;
+        max_freq.emplace_back(cpu, max);
+    }
+    std::lock_guard<std::mutex> lock(g_preflight_mutex);
+    g_run_temp_limit_c = cool ? PREFLIGHT_MAX_TEMP_C : temp + PREFLIGHT_TEMP_MARGIN_C;
+    g_run_max_freq = std::move(max_freq);
+    g_run_start_cool = cool;
+    g_run_baseline_pending = false;
+    LOGI("Preflight: run starts at %.1f C after %d ms, limit %.1f C, %d core(s) already below the hardware maximum",
+         temp, waited_ms, g_run_temp_limit_c, below_hw_max);
+}
+
+PreflightResult run_preflight() {
+    const int timeout_ms = get_run_profile() == RunProfile::QUICK ? PREFLIGHT_TIMEOUT_MS / 4 : PREFLIGHT_TIMEOUT_MS;
+    TRACE_SCOPE("preflight");
+    bool baseline_pending;
+    {
+        std::lock_guard<std::mutex> lock(g_preflight_mutex);
+        baseline_pending = g_run_baseline_pending;
+    }
+    if (baseline_pending) take_run_baseline(PREFLIGHT_COOLDOWN_FACTOR * timeout_ms);
+
+    PreflightResult r;
+    r.valid = true;
+    std::vector<std::pair<int, long>> run_max_freq;
+    {
+        std::lock_guard<std::mutex> lock(g_preflight_mutex);
+        r.temp_limit_c = g_run_temp_limit_c;
+        r.run_start_cool = g_run_start_cool;
+        run_max_freq = g_run_max_freq;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    CpuTimes before = read_cpu_times();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(PREFLIGHT_SAMPLE_MS));
+        CpuTimes after = read_cpu_times();
+        if (before.valid && after.valid && after.total > before.total) {
+            r.busy_pct = 100.0 * (after.busy - before.busy) / (after.total - before.total);
+        }
+        before = after;
+        r.loadavg_1m = read_loadavg();
+        r.max_temp_c = read_max_temp_c();
+        r.capped_cores = count_capped_cores(run_max_freq);
+        r.waited_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count());
+
+        r.quiescent = r.busy_pct < PREFLIGHT_MAX_BUSY_PCT && r.max_temp_c <= r.temp_limit_c && r.capped_cores == 0;
+        if (r.quiescent || r.waited_ms >= timeout_ms) break;
+    }
+    r.noise_score = noise_score(r);
+
+    if (r.quiescent) {
+        LOGI("Preflight: quiet after %d ms (busy %.1f%%, %.1f C, load %.2f)", r.waited_ms, r.busy_pct, r.max_temp_c, r.loadavg_1m);
+    } else {
+        LOGW("Preflight: not quiet after %d ms (busy %.1f%%, %.1f C of %.1f C, %d capped core(s)), noise %.1f",
+             r.waited_ms, r.busy_pct, r.max_temp_c, r.temp_limit_c, r.capped_cores, r.noise_score);
+    }
+    std::lock_guard<std::mutex> lock(g_preflight_mutex);
+    g_last_preflight = r;
+    return r;
+}
+
+PreflightResult last_preflight() {
+    std::lock_guard<std::mutex> lock(g_preflight_mutex);
+    return g_last_preflight;
+}
+
+std::string PreflightResult::to_json() const {
+    if (!valid) return "null";
+    char buf[352];
+    snprintf(buf, sizeof(buf),
+             "{\"quiescent\":%s,\"waited_ms\":%d,\"busy_pct\":%.2f,\"loadavg_1m\":%.2f,\"max_temp_c\":%.1f,"
+             "\"temp_limit_c\":%.1f,\"run_start_cool\":%s,\"capped_cores\":%d,\"noise_score\":%.2f}",
+             quiescent ? "true" : "false", waited_ms, busy_pct, loadavg_1m, max_temp_c, temp_limit_c,
+             run_start_cool ? "true" : "false", capped_cores, noise_score);
+    return buf;
+}
+
+extern "C" {
+
+// Blocks until the system is quiet or the timeout expires; returns the noise score
+JNIEXPORT jdouble JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunPreflight(JNIEnv* /*env*/, jobject /*thiz*/) {
+    return run_preflight().noise_score;
+}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+
+// Pre-flight check before every test: waits, up to a timeout, until the rest of the system is idle,
+// the SoC has cooled down and no core has been frequency-capped since run start, then keeps the last
+// sample so it can be attached to the test's results. Each criterion is skipped when its source is
+// unreadable (untrusted apps cannot read /proc/stat on recent Android versions).
+
+static const double PREFLIGHT_MAX_BUSY_PCT = 10.0;      // CPU time used by others, all cores
+static const double PREFLIGHT_MAX_TEMP_C = 45.0;
+static const double PREFLIGHT_TEMP_MARGIN_C = 3.0;      // above the run-start temperature if it never cools
+static const int PREFLIGHT_SAMPLE_MS = 500;
+static const int PREFLIGHT_TIMEOUT_MS = 30000;          // QUICK profile waits a quarter of this
+static const int PREFLIGHT_COOLDOWN_FACTOR = 4;         // run-start cooldown, in pre-flight timeouts
+
+struct PreflightResult {
+    bool valid = false;         // a pre-flight ran for the current test
+    bool quiescent = false;     // every criterion passed before the timeout
+    int waited_ms = 0;
+    double busy_pct = -1.0;     // from /proc/stat, -1 if unreadable
+    double loadavg_1m = -1.0;
+    double max_temp_c = -1.0;   // hottest thermal zone, -1 if none readable
+    double temp_limit_c = PREFLIGHT_MAX_TEMP_C;
+    bool run_start_cool = true; // the run-start cooldown reached PREFLIGHT_MAX_TEMP_C
+    int capped_cores = 0;       // cores whose scaling_max_freq dropped below its value at run start
+    double noise_score = 0.0;   // 0 = quiet; see preflight.cpp
+
+    std::string to_json() const;
+};
+
+// Called at run start. The first run_preflight() of the run then waits for the device to cool to
+// PREFLIGHT_MAX_TEMP_C, which becomes the limit, and every core's scaling_max_freq at that point becomes
+// its uncapped baseline; only a device that never cools gets a limit of its current temperature + margin.
+void preflight_begin_run();
+PreflightResult run_preflight();
+PreflightResult last_preflight();
@@ -10,6 +10,11 @@
 #include <fstream>
 #include <string>
 #include "utils.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
 
 // Function to prevent optimization
 template <class T>
@@ -17,26 +22,41 @@ __attribute__((always_inline)) inline void do_not_optimize(T const& value) {
     asm volatile("" : : "r,m"(value) : "memory");
 }
 
+static const size_t RAM_FULL_BUFFER_SIZE = 768 * 1024 * 1024; // 768 MB
+
+// Scaled buffer, but always far beyond the last-level cache so the test stays a DRAM test
+static size_t ram_buffer_size() {
+    size_t min_size = std::max<size_t>(64 * 1024 * 1024, 8 * read_device_resources().last_level_cache);
+    return size_memory_bytes(RAM_FULL_BUFFER_SIZE, min_size, 1024 * 1024);
+}
+
 extern "C" {
 
 JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamSequentialWriteBenchmark(
         JNIEnv* env, jobject thiz, jobject activity) {
 
-    const size_t buffer_size = 768 * 1024 * 1024; // 768 MB
+    const size_t buffer_size = ram_buffer_size();
     int big_core = get_biggest_core();
     pin_to_core(big_core);
 
     jclass activityClass = env->GetObjectClass(activity);
     jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
 
+    TraceScope alloc_trace("ram_buffer_alloc");
     volatile char* buffer = new (std::nothrow) char[buffer_size];
     if (!buffer) return -1;
+    // Fault the buffer in up front; otherwise the timed loop measures page faults as much as stores
+    prefault_pages(const_cast<char*>(buffer), buffer_size);
+    alloc_trace.end();
 
     const int total_progress_updates = 100;
     size_t progress_step = buffer_size / total_progress_updates;
 
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;
+    TraceScope loop_trace("ram_timed_loop");
 
     for (size_t i = 0; i < buffer_size; i++) {
         buffer[i] = static_cast<char>(i & 0xFF);
@@ -50,31 +70,41 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamSequentialWriteBe
 
     asm volatile("" : : : "memory");
     std::atomic_thread_fence(std::memory_order_seq_cst);
+    perf.stop();
+    loop_trace.end();
 
     update_progress(env, activity, updateProgressMethod, 1.0f);
     auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
 
     delete[] buffer;
-    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong full_ms = scale_to_full_work(ms, buffer_size, RAM_FULL_BUFFER_SIZE);
+    record_result(env, activity, BenchRecord("ram_seq_write", full_ms, "ms")
+            .on_core(big_core).metric("mb_per_s", ms > 0 ? buffer_size / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0)
+            .metric("measured_ms", ms).param("buffer_bytes", buffer_size));
+    return full_ms;
 }
 
 JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamSequentialReadBenchmark(
         JNIEnv* env, jobject thiz, jobject activity) {
 
-    const size_t buffer_size = 768 * 1024 * 1024; // 768 MB
+    const size_t buffer_size = ram_buffer_size();
     int big_core = get_biggest_core();
     pin_to_core(big_core);
 
     jclass activityClass = env->GetObjectClass(activity);
     jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
 
+    TraceScope alloc_trace("ram_buffer_alloc");
     char* non_volatile_buffer = new (std::nothrow) char[buffer_size];
     if (!non_volatile_buffer) return -1;
 
     for (size_t i = 0; i < buffer_size; i++) {
         non_volatile_buffer[i] = static_cast<char>(i & 0xFF);
     }
+    alloc_trace.end();
 
     volatile char* buffer = static_cast<volatile char*>(non_volatile_buffer);
     volatile char sum = 0;
@@ -82,7 +112,10 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamSequentialReadBen
     const int total_progress_updates = 100;
     size_t progress_step = buffer_size / total_progress_updates;
 
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
+    PerfRegion perf;
+    TraceScope loop_trace("ram_timed_loop");
 
     for (size_t i = 0; i < buffer_size; i++) {
         char value = buffer[i];
@@ -97,13 +130,21 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamSequentialReadBen
 
     asm volatile("" : : : "memory");
     std::atomic_thread_fence(std::memory_order_seq_cst);
+    perf.stop();
+    loop_trace.end();
     do_not_optimize(sum);
 
     update_progress(env, activity, updateProgressMethod, 1.0f);
     auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
 
     delete[] non_volatile_buffer;
-    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong full_ms = scale_to_full_work(ms, buffer_size, RAM_FULL_BUFFER_SIZE);
+    record_result(env, activity, BenchRecord("ram_seq_read", full_ms, "ms")
+            .on_core(big_core).metric("mb_per_s", ms > 0 ? buffer_size / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0)
+            .metric("measured_ms", ms).param("buffer_bytes", buffer_size));
+    return full_ms;
 }
 
 }
\ No newline at end of file
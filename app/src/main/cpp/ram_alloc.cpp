@@ -0,0 +1,365 @@
+#include <jni.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include "utils.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+
+// Allocator throughput: replays allocation traces against the system allocator (scudo on Android,
+// glibc on Linux) and against a small in-tree thread-local pool allocator used as a baseline.
+//   churn     - random small-object alloc/free over a live set, like a parser or UI tree
+//   handoff   - producer allocates messages, consumer on another thread frees them
+//   realloc   - a buffer grown by 1.5x up to 8 MB and dropped, like a response body
+// The score is the system allocator time; the pool numbers are logged for comparison.
+
+static const int CHURN_OPS_PER_THREAD = 10000000;
+static const int CHURN_LIVE_SLOTS = 4096;
+static const int HANDOFF_MESSAGES_PER_PAIR = 4000000;
+static const int HANDOFF_RING_SIZE = 1024;
+static const int REALLOC_ROUNDS_PER_THREAD = 200;
+static const size_t REALLOC_MIN = 4 * 1024;
+static const size_t REALLOC_MAX = 8 * 1024 * 1024;
+
+// --- System allocator ---
+
+struct SystemAllocator {
+    static void* alloc(size_t size) { return malloc(size); }
+    static void release(void* p) { free(p); }
+    static void* grow(void* p, size_t /*old_size*/, size_t new_size) { return realloc(p, new_size); }
+};
+
+// --- Thread-local pool allocator ---
+// Power-of-two size classes from 16 B to 1 KB carved from 64 KB slabs. Every block carries a header
+// with its owning arena; a block freed by another thread is pushed onto the owner's lock-free
+// remote list and reclaimed by the owner on its next refill. Larger requests go to malloc.
+
+static const int POOL_CLASS_COUNT = 7;
+static const size_t POOL_MAX_SIZE = 1024;
+static const size_t POOL_SLAB_SIZE = 64 * 1024;
+
+struct PoolArena;
+
+struct PoolHeader {
+    PoolArena* owner;       // nullptr for blocks that came from malloc
+    uint32_t size_class;
+    uint32_t reserved;
+};
+
+// Free-list entries live at the block header; the link overlaps only the owner field,
+// so the size class is still readable after a block is freed.
+struct PoolFreeBlock {
+    PoolFreeBlock* next;
+};
+
+struct PoolArena {
+    PoolFreeBlock* free_lists[POOL_CLASS_COUNT] = {};
+    std::atomic<PoolFreeBlock*> remote_free{nullptr};   // headers of blocks freed by other threads
+    std::vector<void*> slabs;
+
+    ~PoolArena() {
+        for (void* s : slabs) free(s);
+    }
+};
+
+static thread_local PoolArena* t_pool_arena = nullptr;
+
+static inline int pool_size_class(size_t size) {
+    int c = 0;
+    size_t class_size = 16;
+    while (class_size < size) { class_size <<= 1; ++c; }
+    return c;
+}
+
+static inline size_t pool_block_size(int size_class) {
+    return sizeof(PoolHeader) + (size_t(16) << size_class);
+}
+
+static void pool_refill(PoolArena& arena, int size_class) {
+    // Reclaim blocks other threads have handed back first
+    PoolFreeBlock* remote = arena.remote_free.exchange(nullptr, std::memory_order_acquire);
+    while (remote) {
+        PoolFreeBlock* next = remote->next;
+        uint32_t remote_class = reinterpret_cast<PoolHeader*>(remote)->size_class;
+        remote->next = arena.free_lists[remote_class];
+        arena.free_lists[remote_class] = remote;
+        remote = next;
+    }
+    if (arena.free_lists[size_class]) return;
+
+    const size_t block_size = pool_block_size(size_class);
+    auto* slab = static_cast<uint8_t*>(malloc(POOL_SLAB_SIZE));
+    if (!slab) return;
+    arena.slabs.push_back(slab);
+    for (size_t off = 0; off + block_size <= POOL_SLAB_SIZE; off += block_size) {
+        auto* block = reinterpret_cast<PoolFreeBlock*>(slab + off);
+        block->next = arena.free_lists[size_class];
+        arena.free_lists[size_class] = block;
+    }
+}
+
+struct PoolAllocator {
+    static void* alloc(size_t size) {
+        PoolArena* arena = t_pool_arena;
+        if (size > POOL_MAX_SIZE || !arena) {
+            auto* header = static_cast<PoolHeader*>(malloc(sizeof(PoolHeader) + size));
+            if (!header) return nullptr;
+            header->owner = nullptr;
+            return header + 1;
+        }
+        int size_class = pool_size_class(size);
+        if (!arena->free_lists[size_class]) pool_refill(*arena, size_class);
+        PoolFreeBlock* block = arena->free_lists[size_class];
+        if (!block) return nullptr;
+        arena->free_lists[size_class] = block->next;
+
+        auto* header = reinterpret_cast<PoolHeader*>(block);
+        header->owner = arena;
+        header->size_class = static_cast<uint32_t>(size_class);
+        return header + 1;
+    }
+
+    static void release(void* p) {
+        if (!p) return;
+        auto* header = static_cast<PoolHeader*>(p) - 1;
+        PoolArena* owner = header->owner;
+        if (!owner) {
+            free(header);
+            return;
+        }
+        auto* block = reinterpret_cast<PoolFreeBlock*>(header);
+        if (owner == t_pool_arena) {
+            block->next = owner->free_lists[header->size_class];
+            owner->free_lists[header->size_class] = block;
+            return;
+        }
+        PoolFreeBlock* head = owner->remote_free.load(std::memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!owner->remote_free.compare_exchange_weak(head, block, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+    }
+
+    static void* grow(void* p, size_t old_size, size_t new_size) {
+        if (!p) return alloc(new_size);
+        auto* header = static_cast<PoolHeader*>(p) - 1;
+        if (!header->owner && new_size > POOL_MAX_SIZE) {
+            auto* grown = static_cast<PoolHeader*>(realloc(header, sizeof(PoolHeader) + new_size));
+            return grown ? grown + 1 : nullptr;
+        }
+        void* fresh = alloc(new_size);
+        if (fresh) {
+            memcpy(fresh, p, std::min(old_size, new_size));
+            release(p);
+        }
+        return fresh;
+    }
+};
+
+// --- Traces ---
+
+// Size mix skewed towards small objects: 60% 16-64 B, 30% up to 256 B, 10% up to 1 KB
+static inline size_t churn_size(std::mt19937& gen) {
+    uint32_t r = gen();
+    uint32_t bucket = r % 10;
+    size_t max_size = bucket < 6 ? 64 : (bucket < 9 ? 256 : 1024);
+    return 16 + (r >> 8) % (max_size - 15);
+}
+
+template <class Alloc>
+static bool trace_churn(int thread_index) {
+    std::mt19937 gen(1000 + thread_index);
+    std::vector<void*> slots(CHURN_LIVE_SLOTS, nullptr);
+    bool ok = true;
+    for (int i = 0; i < CHURN_OPS_PER_THREAD; ++i) {
+        void*& slot = slots[gen() % CHURN_LIVE_SLOTS];
+        if (slot) {
+            Alloc::release(slot);
+            slot = nullptr;
+        } else {
+            size_t size = churn_size(gen);
+            slot = Alloc::alloc(size);
+            if (!slot) { ok = false; break; }
+            memset(slot, i & 0xFF, std::min<size_t>(size, 32));
+        }
+    }
+    for (void* p : slots) Alloc::release(p);
+    return ok;
+}
+
+struct HandoffRing {
+    void* items[HANDOFF_RING_SIZE];
+    alignas(64) std::atomic<uint32_t> head{0};   // next slot to consume
+    alignas(64) std::atomic<uint32_t> tail{0};   // next slot to produce
+};
+
+template <class Alloc>
+static bool trace_handoff_producer(HandoffRing& ring, int pair_index) {
+    std::mt19937 gen(2000 + pair_index);
+    for (int i = 0; i < HANDOFF_MESSAGES_PER_PAIR; ++i) {
+        size_t size = 64 + gen() % 449;
+        auto* msg = static_cast<uint32_t*>(Alloc::alloc(size));
+        if (!msg) return false;
+        msg[0] = static_cast<uint32_t>(i);
+
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        while (tail - ring.head.load(std::memory_order_acquire) >= HANDOFF_RING_SIZE) std::this_thread::yield();
+        ring.items[tail % HANDOFF_RING_SIZE] = msg;
+        ring.tail.store(tail + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+template <class Alloc>
+static bool trace_handoff_consumer(HandoffRing& ring) {
+    bool ok = true;
+    for (int i = 0; i < HANDOFF_MESSAGES_PER_PAIR; ++i) {
+        uint32_t head = ring.head.load(std::memory_order_relaxed);
+        while (ring.tail.load(std::memory_order_acquire) == head) std::this_thread::yield();
+        auto* msg = static_cast<uint32_t*>(ring.items[head % HANDOFF_RING_SIZE]);
+        if (msg[0] != static_cast<uint32_t>(i)) ok = false;
+        Alloc::release(msg);
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+    return ok;
+}
+
+template <class Alloc>
+static bool trace_realloc() {
+    for (int round = 0; round < REALLOC_ROUNDS_PER_THREAD; ++round) {
+        size_t size = REALLOC_MIN;
+        auto* buffer = static_cast<uint8_t*>(Alloc::alloc(size));
+        if (!buffer) return false;
+        memset(buffer, 0, size);
+        while (size < REALLOC_MAX) {
+            size_t new_size = std::min(REALLOC_MAX, size + size / 2);
+            auto* grown = static_cast<uint8_t*>(Alloc::grow(buffer, size, new_size));
+            if (!grown) { Alloc::release(buffer); return false; }
+            memset(grown + size, round & 0xFF, new_size - size);
+            buffer = grown;
+            size = new_size;
+        }
+        Alloc::release(buffer);
+    }
+    return true;
+}
+
+// Runs fn(thread_index) on one thread per entry of cores and returns the wall time in seconds,
+// or a negative value if any thread reported failure. Each thread gets its own pool arena.
+template <class Fn>
+static double run_alloc_threads(const std::vector<int>& cores, Fn fn) {
+    std::vector<PoolArena> arenas(cores.size());
+    std::atomic<bool> failed{false};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(cores.size());
+
+    for (size_t t = 0; t < cores.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            pin_to_core(cores[t]);
+            setpriority(PRIO_PROCESS, 0, -10);
+            t_pool_arena = &arenas[t];
+            PerfRegion perf;
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            TraceScope trace("alloc_trace", static_cast<int64_t>(t));
+            if (!fn(static_cast<int>(t))) failed = true;
+            trace.end();
+            perf.stop();
+            t_pool_arena = nullptr;
+        });
+    }
+
+    while (ready.load() < static_cast<int>(cores.size())) std::this_thread::yield();
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
+
+    // Arenas are destroyed only after every thread has exited, so cross-thread frees stay valid
+    return failed ? -1.0 : std::chrono::duration<double>(end - start).count();
+}
+
+// Seconds for the three traces with the given allocator; negative on failure
+template <class Alloc>
+static double run_alloc_traces(const std::vector<int>& cores, double phase_seconds[3]) {
+    const int n = static_cast<int>(cores.size());
+
+    phase_seconds[0] = run_alloc_threads(cores, [](int t) { return trace_churn<Alloc>(t); });
+
+    // Producer/consumer pairs; a single core still gets one pair so frees always cross threads
+    const int pairs = std::max(1, n / 2);
+    std::vector<int> pair_cores;
+    for (int p = 0; p < pairs; ++p) {
+        pair_cores.push_back(cores[(2 * p) % n]);
+        pair_cores.push_back(cores[(2 * p + 1) % n]);
+    }
+    std::vector<HandoffRing> rings(pairs);
+    phase_seconds[1] = run_alloc_threads(pair_cores, [&rings](int t) {
+        HandoffRing& ring = rings[t / 2];
+        return (t % 2 == 0) ? trace_handoff_producer<Alloc>(ring, t / 2) : trace_handoff_consumer<Alloc>(ring);
+    });
+
+    phase_seconds[2] = run_alloc_threads(cores, [](int) { return trace_realloc<Alloc>(); });
+
+    if (phase_seconds[0] < 0 || phase_seconds[1] < 0 || phase_seconds[2] < 0) return -1.0;
+    return phase_seconds[0] + phase_seconds[1] + phase_seconds[2];
+}
+
+static jlong run_alloc_benchmark(JNIEnv* env, jobject activity, const char* test, const std::vector<int>& cores) {
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    static const char* trace_names[3] = {"churn", "handoff", "realloc"};
+    double system_phases[3], pool_phases[3];
+
+    double system_seconds = run_alloc_traces<SystemAllocator>(cores, system_phases);
+    update_progress(env, activity, updateProgressMethod, 0.5f);
+    double pool_seconds = run_alloc_traces<PoolAllocator>(cores, pool_phases);
+    update_progress(env, activity, updateProgressMethod, 1.0f);
+
+    if (system_seconds < 0 || pool_seconds < 0) {
+        LOGE("Allocator benchmark: trace failed");
+        return -1;
+    }
+
+    BenchRecord record(test, static_cast<jlong>(system_seconds * 1000.0), "ms");
+    record.on_cores(cores);
+    for (int i = 0; i < 3; ++i) {
+        LOGI("Alloc %-8s %zu thread(s): system %.1f ms, pool %.1f ms (%.2fx)", trace_names[i], cores.size(),
+             system_phases[i] * 1000.0, pool_phases[i] * 1000.0,
+             pool_phases[i] > 0 ? system_phases[i] / pool_phases[i] : 0.0);
+        record.metric(std::string(trace_names[i]) + "_system_ms", system_phases[i] * 1000.0)
+              .metric(std::string(trace_names[i]) + "_pool_ms", pool_phases[i] * 1000.0);
+    }
+
+    record_result(env, activity, record);
+    return record.result;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamAllocSingleThreadBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_alloc_benchmark(env, activity, "ram_alloc_single", {get_biggest_core()});
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamAllocMultiThreadBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    return run_alloc_benchmark(env, activity, "ram_alloc_multi", get_performance_cores());
+}
+
+}
@@ -0,0 +1,210 @@
+#include <jni.h>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "utils.h"
+#include "results.h"
+#include "energy.h"
+#include "sizing.h"
+
+// Cost of committing and releasing anonymous memory, one phase per fresh mapping on the biggest core:
+//   first_touch - plain mmap, one store per 4 KB page (THP disabled for the mapping)
+//   populate    - mmap(MAP_POPULATE): the kernel commits everything inside the mmap call
+//   willneed    - madvise(MADV_WILLNEED) then touch; only a hint for anonymous memory, shown for comparison
+//   thp         - 2 MB aligned mapping with MADV_HUGEPAGE, one store per 4 KB
+//   dontneed    - MADV_DONTNEED on touched memory, then the refault of the zeroed pages
+//   free        - MADV_FREE on touched memory (lazy release), then the retouch
+//   mlock       - mlock of a fresh mapping, limited by RLIMIT_MEMLOCK
+// Faults come from getrusage(RUSAGE_THREAD) minor fault counts, GB/s is committed (or released) bytes.
+// The score is the total time of the commit phases: first_touch, dontneed refault, populate, willneed and thp.
+
+static const size_t FAULT_FULL_BYTES = 512 * 1024 * 1024;
+static const size_t FAULT_MIN_BYTES = 32 * 1024 * 1024;
+static const size_t FAULT_HUGE_PAGE = 2 * 1024 * 1024;
+
+struct FaultSample {
+    double seconds = 0.0;
+    long faults = 0;
+};
+
+static long thread_minor_faults() {
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_minflt;
+}
+
+template <class Fn>
+static FaultSample measure_faults(Fn fn) {
+    FaultSample sample;
+    long faults_before = thread_minor_faults();
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
+    sample.faults = thread_minor_faults() - faults_before;
+    sample.seconds = std::chrono::duration<double>(end - start).count();
+    return sample;
+}
+
+static void touch_pages(uint8_t* data, size_t size, size_t page_size) {
+    for (size_t offset = 0; offset < size; offset += page_size) {
+        *static_cast<volatile uint8_t*>(data + offset) = 1;
+    }
+}
+
+static uint8_t* map_anonymous(size_t size, int extra_flags = 0) {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return p == MAP_FAILED ? nullptr : static_cast<uint8_t*>(p);
+}
+
+// 0 = never, 1 = madvise, 2 = always, -1 if the kernel has no THP
+static int thp_mode() {
+    std::ifstream f("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string line;
+    if (!f.is_open() || !std::getline(f, line)) return -1;
+    if (line.find("[always]") != std::string::npos) return 2;
+    if (line.find("[madvise]") != std::string::npos) return 1;
+    return 0;
+}
+
+static double gb_per_s(size_t bytes, double seconds) {
+    return seconds > 0 ? bytes / seconds / 1e9 : 0.0;
+}
+
+static void add_fault_metrics(BenchRecord& record, const char* phase, size_t bytes, const FaultSample& s) {
+    LOGI("Page faults %-12s %6zu MB: %8.1f ms, %9ld faults, %10.0f faults/s, %6.2f GB/s", phase, bytes >> 20,
+         s.seconds * 1000.0, s.faults, s.seconds > 0 ? s.faults / s.seconds : 0.0, gb_per_s(bytes, s.seconds));
+    const std::string name = phase;
+    record.metric(name + "_ms", s.seconds * 1000.0)
+          .metric(name + "_faults", s.faults)
+          .metric(name + "_faults_per_s", s.seconds > 0 ? s.faults / s.seconds : 0.0)
+          .metric(name + "_gb_s", gb_per_s(bytes, s.seconds));
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamPageFaultBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t bytes = size_memory_bytes(FAULT_FULL_BYTES, FAULT_MIN_BYTES, FAULT_HUGE_PAGE);
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+    const float total_phases = 7.0f;
+
+    int big_core = get_biggest_core();
+    pin_to_core(big_core);
+    setpriority(PRIO_PROCESS, 0, -10);
+
+    BenchRecord record("ram_page_fault", 0, "ms");
+    record.on_core(big_core).param("bytes", bytes).param("page_size", page_size).param("thp_mode", thp_mode());
+    double score_seconds = 0.0;
+
+    // first_touch, then release the same touched mapping with MADV_DONTNEED and refault it
+    uint8_t* p = map_anonymous(bytes);
+    if (!p) { LOGE("Page faults: mmap of %zu MB failed (errno %d)", bytes >> 20, errno); return -1; }
+    madvise(p, bytes, MADV_NOHUGEPAGE);
+    FaultSample first_touch = measure_faults([&] { touch_pages(p, bytes, page_size); });
+    add_fault_metrics(record, "first_touch", bytes, first_touch);
+    score_seconds += first_touch.seconds;
+    update_progress(env, activity, updateProgressMethod, 1 / total_phases);
+
+    FaultSample dontneed = measure_faults([&] { madvise(p, bytes, MADV_DONTNEED); });
+    FaultSample refault = measure_faults([&] { touch_pages(p, bytes, page_size); });
+    munmap(p, bytes);
+    add_fault_metrics(record, "dontneed", bytes, dontneed);
+    add_fault_metrics(record, "dontneed_refault", bytes, refault);
+    score_seconds += refault.seconds;
+    update_progress(env, activity, updateProgressMethod, 2 / total_phases);
+
+    // populate: the whole commit happens inside mmap, the touch afterwards should not fault
+    FaultSample populate = measure_faults([&] { p = map_anonymous(bytes, MAP_POPULATE); });
+    if (!p) { LOGE("Page faults: MAP_POPULATE mmap failed (errno %d)", errno); return -1; }
+    FaultSample populate_touch = measure_faults([&] { touch_pages(p, bytes, page_size); });
+    munmap(p, bytes);
+    add_fault_metrics(record, "populate", bytes, populate);
+    add_fault_metrics(record, "populate_touch", bytes, populate_touch);
+    score_seconds += populate.seconds;
+    update_progress(env, activity, updateProgressMethod, 3 / total_phases);
+
+    // willneed: hint plus touch, timed together
+    p = map_anonymous(bytes);
+    if (!p) { LOGE("Page faults: mmap failed (errno %d)", errno); return -1; }
+    FaultSample willneed = measure_faults([&] {
+        madvise(p, bytes, MADV_WILLNEED);
+        touch_pages(p, bytes, page_size);
+    });
+    munmap(p, bytes);
+    add_fault_metrics(record, "willneed", bytes, willneed);
+    score_seconds += willneed.seconds;
+    update_progress(env, activity, updateProgressMethod, 4 / total_phases);
+
+    // thp: over-map by one huge page and align, so the region can be backed by 2 MB pages
+    uint8_t* raw = map_anonymous(bytes + FAULT_HUGE_PAGE);
+    if (!raw) { LOGE("Page faults: mmap failed (errno %d)", errno); return -1; }
+    p = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(raw) + FAULT_HUGE_PAGE - 1) & ~(FAULT_HUGE_PAGE - 1));
+    if (madvise(p, bytes, MADV_HUGEPAGE) != 0) LOGW("Page faults: MADV_HUGEPAGE rejected (errno %d)", errno);
+    FaultSample thp = measure_faults([&] { touch_pages(p, bytes, page_size); });
+    munmap(raw, bytes + FAULT_HUGE_PAGE);
+    add_fault_metrics(record, "thp", bytes, thp);
+    score_seconds += thp.seconds;
+    update_progress(env, activity, updateProgressMethod, 5 / total_phases);
+
+    // free: lazy release, pages stay mapped until the kernel is under memory pressure
+    p = map_anonymous(bytes);
+    if (!p) { LOGE("Page faults: mmap failed (errno %d)", errno); return -1; }
+    touch_pages(p, bytes, page_size);
+#ifdef MADV_FREE
+    int free_result = 0;
+    FaultSample madv_free = measure_faults([&] { free_result = madvise(p, bytes, MADV_FREE); });
+    if (free_result == 0) {
+        FaultSample free_retouch = measure_faults([&] { touch_pages(p, bytes, page_size); });
+        add_fault_metrics(record, "free", bytes, madv_free);
+        add_fault_metrics(record, "free_retouch", bytes, free_retouch);
+    } else {
+        LOGW("Page faults: MADV_FREE not supported by this kernel (errno %d)", errno);
+    }
+#endif
+    munmap(p, bytes);
+    update_progress(env, activity, updateProgressMethod, 6 / total_phases);
+
+    // mlock: commit and pin; apps usually get a small RLIMIT_MEMLOCK, so the size follows the limit
+    rlimit memlock{};
+    size_t lock_bytes = bytes;
+    if (getrlimit(RLIMIT_MEMLOCK, &memlock) == 0 && memlock.rlim_cur != RLIM_INFINITY) {
+        lock_bytes = std::min<size_t>(bytes, memlock.rlim_cur / page_size * page_size);
+    }
+    record.param("mlock_bytes", lock_bytes);
+    if (lock_bytes > 0 && (p = map_anonymous(lock_bytes))) {
+        int lock_result = 0;
+        FaultSample lock = measure_faults([&] { lock_result = mlock(p, lock_bytes); });
+        if (lock_result == 0) {
+            add_fault_metrics(record, "mlock", lock_bytes, lock);
+            munlock(p, lock_bytes);
+        } else {
+            LOGW("Page faults: mlock of %zu KB failed (errno %d)", lock_bytes >> 10, errno);
+        }
+        munmap(p, lock_bytes);
+    } else {
+        LOGW("Page faults: RLIMIT_MEMLOCK allows no locked memory, mlock skipped");
+    }
+    update_progress(env, activity, updateProgressMethod, 1.0f);
+
+    const jlong ms = static_cast<jlong>(score_seconds * 1000.0);
+    record.result = scale_to_full_work(ms, bytes, FAULT_FULL_BYTES);
+    record.metric("measured_ms", ms);
+    record_result(env, activity, record);
+    return record.result;
+}
+
+}
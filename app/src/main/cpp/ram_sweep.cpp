@@ -0,0 +1,293 @@
+#include <jni.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/resource.h>
+#include "utils.h"
+#include "results.h"
+#include "trace.h"
+#include "perf_counters.h"
+#include "energy.h"
+#include "sizing.h"
+#include "topology.h"
+#include "contention.h"
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Bandwidth against working-set size. Read, write and read-modify-write kernels stream over
+// working sets from 16 KB to 512 MB, first on the biggest core, then on every core of its cluster
+// (the set is split evenly between the threads, so the x axis is the total footprint).
+// Every point moves about the same number of bytes, so small sets are simply repeated more often.
+// GB/s counts the bytes the kernel touches: RMW reads and writes every byte, so it counts twice.
+// The full curve is stored in the result record; the log prints one line per point for plotting.
+// The result only uses the fixed SWEEP_SCORE_SIZES, which every device runs whatever its free RAM: the
+// time a full SWEEP_TRAFFIC_PER_POINT point would take at each one's measured bandwidth, summed.
+
+static const size_t SWEEP_MIN_BYTES = 16 * 1024;
+static const size_t SWEEP_MAX_BYTES = 512 * 1024 * 1024;
+static const unsigned long long SWEEP_TRAFFIC_PER_POINT = 256ULL * 1024 * 1024;
+static const size_t SWEEP_ALIGN = 64;      // bytes per kernel iteration, also the buffer alignment
+// L1, L2, last-level cache and DRAM on most SoCs; all within the 64 MB minimum of the clamped maximum
+static const size_t SWEEP_SCORE_SIZES[] = {16 * 1024, 256 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024};
+
+enum class SweepKernel { READ, WRITE, RMW };
+
+struct SweepKernelInfo {
+    SweepKernel kernel;
+    const char* name;
+    int touches;            // bytes counted per byte of the working set
+};
+
+static const SweepKernelInfo SWEEP_KERNELS[] = {
+        {SweepKernel::READ, "read", 1},
+        {SweepKernel::WRITE, "write", 1},
+        {SweepKernel::RMW, "rmw", 2},
+};
+
+template <class T>
+__attribute__((always_inline)) inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// One pass over [p, p + bytes); bytes is a multiple of SWEEP_ALIGN.
+// Four independent 16-byte lanes per iteration keep enough loads in flight on wide cores.
+static uint64_t sweep_pass(SweepKernel kernel, uint64_t* p, size_t bytes) {
+    const size_t words = bytes / sizeof(uint64_t);
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    switch (kernel) {
+        case SweepKernel::READ: {
+            uint64x2_t s0 = vdupq_n_u64(0), s1 = s0, s2 = s0, s3 = s0;
+            for (size_t i = 0; i < words; i += 8) {
+                s0 = vaddq_u64(s0, vld1q_u64(p + i));
+                s1 = vaddq_u64(s1, vld1q_u64(p + i + 2));
+                s2 = vaddq_u64(s2, vld1q_u64(p + i + 4));
+                s3 = vaddq_u64(s3, vld1q_u64(p + i + 6));
+            }
+            uint64x2_t s = vaddq_u64(vaddq_u64(s0, s1), vaddq_u64(s2, s3));
+            return vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1);
+        }
+        case SweepKernel::WRITE: {
+            const uint64x2_t v = vdupq_n_u64(0x5a5a5a5a5a5a5a5aULL);
+            for (size_t i = 0; i < words; i += 8) {
+                vst1q_u64(p + i, v);
+                vst1q_u64(p + i + 2, v);
+                vst1q_u64(p + i + 4, v);
+                vst1q_u64(p + i + 6, v);
+            }
+            return 0;
+        }
+        case SweepKernel::RMW: {
+            const uint64x2_t one = vdupq_n_u64(1);
+            for (size_t i = 0; i < words; i += 8) {
+                vst1q_u64(p + i, vaddq_u64(vld1q_u64(p + i), one));
+                vst1q_u64(p + i + 2, vaddq_u64(vld1q_u64(p + i + 2), one));
+                vst1q_u64(p + i + 4, vaddq_u64(vld1q_u64(p + i + 4), one));
+                vst1q_u64(p + i + 6, vaddq_u64(vld1q_u64(p + i + 6), one));
+            }
+            return 0;
+        }
+    }
+    return 0;
+#else
+    // Plain 64-bit loops, vectorized by the compiler
+    switch (kernel) {
+        case SweepKernel::READ: {
+            uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (size_t i = 0; i < words; i += 4) {
+                s0 += p[i]; s1 += p[i + 1]; s2 += p[i + 2]; s3 += p[i + 3];
+            }
+            return s0 + s1 + s2 + s3;
+        }
+        case SweepKernel::WRITE:
+            for (size_t i = 0; i < words; ++i) p[i] = 0x5a5a5a5a5a5a5a5aULL;
+            return 0;
+        case SweepKernel::RMW:
+            for (size_t i = 0; i < words; ++i) p[i] += 1;
+            return 0;
+    }
+    return 0;
+#endif
+}
+
+// Runs passes over one slice per core and returns the wall time of the timed passes in seconds.
+// Every thread warms its slice first (caches, TLB) and waits for the others before the clock starts.
+static double run_sweep_point(const std::vector<int>& cores, uint8_t* buffer, size_t working_set,
+                              SweepKernel kernel, unsigned long long passes) {
+    const size_t slice = std::max(SWEEP_ALIGN, working_set / cores.size() / SWEEP_ALIGN * SWEEP_ALIGN);
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::chrono::high_resolution_clock::time_point> ends(cores.size());
+    std::vector<std::thread> threads;
+    threads.reserve(cores.size());
+
+    for (size_t t = 0; t < cores.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            pin_to_core(cores[t]);
+            setpriority(PRIO_PROCESS, 0, -10);
+            auto* p = reinterpret_cast<uint64_t*>(buffer + t * slice);
+            TraceScope warm_trace("sweep_warmup", static_cast<int64_t>(slice));
+            do_not_optimize(sweep_pass(kernel, p, slice));
+            warm_trace.end();
+            PerfRegion perf;    // after the warm-up pass
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            TRACE_SCOPE("sweep_passes", static_cast<int64_t>(slice));
+            uint64_t sink = 0;
+            for (unsigned long long pass = 0; pass < passes; ++pass) {
+                sink += sweep_pass(kernel, p, slice);
+                asm volatile("" : : : "memory");
+            }
+            do_not_optimize(sink);
+            ends[t] = std::chrono::high_resolution_clock::now();
+            perf.stop();
+        });
+    }
+
+    while (ready.load() < static_cast<int>(cores.size())) std::this_thread::yield();
+    EnergyRegion energy;
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    energy.stop();
+    return std::chrono::duration<double>(*std::max_element(ends.begin(), ends.end()) - start).count();
+}
+
+// Cores of the biggest core's cluster; on a lone prime core the next cluster that has several
+static std::vector<int> sweep_cluster_cores() {
+    const CpuTopology& topo = get_cpu_topology();
+    for (auto it = topo.clusters.rbegin(); it != topo.clusters.rend(); ++it) {
+        if (it->cpus.size() > 1) return it->cpus;
+    }
+    return topo.online.empty() ? std::vector<int>{get_biggest_core()} : topo.online;
+}
+
+static std::string sweep_size_label(size_t bytes) {
+    return bytes >= 1024 * 1024 ? std::to_string(bytes >> 20) + "MB" : std::to_string(bytes >> 10) + "KB";
+}
+
+// Read kernel over a buffer far past the last-level cache, split between the given cores
+class RamBandwidthLoad : public ContentionLoad {
+public:
+    ~RamBandwidthLoad() override { free(buffer_); }
+
+    const char* name() const override { return "ram_read"; }
+    const char* unit() const override { return "gb_s"; }
+    int max_cores() const override { return 2; }
+
+    bool prepare() override {
+        bytes_ = size_memory_bytes(128 * 1024 * 1024, 32 * 1024 * 1024, 1024 * 1024);
+        buffer_ = static_cast<uint8_t*>(aligned_alloc(SWEEP_ALIGN, bytes_));
+        if (!buffer_) return false;
+        memset(buffer_, 1, bytes_);
+        return true;
+    }
+
+    double run(const std::vector<int>& cores, const std::atomic<bool>& stop) override {
+        const size_t slice = bytes_ / cores.size() / SWEEP_ALIGN * SWEEP_ALIGN;
+        std::atomic<unsigned long long> bytes_read{0};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < cores.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                pin_to_core(cores[t]);
+                setpriority(PRIO_PROCESS, 0, -10);
+                TRACE_SCOPE("contention_ram_read", static_cast<int64_t>(slice));
+                auto* p = reinterpret_cast<uint64_t*>(buffer_ + t * slice);
+                uint64_t sink = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    sink += sweep_pass(SweepKernel::READ, p, slice);
+                    bytes_read.fetch_add(slice, std::memory_order_relaxed);
+                }
+                do_not_optimize(sink);
+            });
+        }
+        for (auto& th : threads) th.join();
+        return bytes_read.load() / 1e9;
+    }
+
+private:
+    uint8_t* buffer_ = nullptr;
+    size_t bytes_ = 0;
+};
+
+std::unique_ptr<ContentionLoad> make_ram_bandwidth_load() {
+    return std::make_unique<RamBandwidthLoad>();
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRamBandwidthSweepBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    // The largest set only needs to be well past the last-level cache, so it is clamped like the RAM tests
+    const size_t max_bytes = size_memory_bytes(SWEEP_MAX_BYTES, 64 * 1024 * 1024, 1024 * 1024);
+    const unsigned long long traffic = size_work(SWEEP_TRAFFIC_PER_POINT);
+
+    TraceScope alloc_trace("sweep_buffer_alloc");
+    auto* buffer = static_cast<uint8_t*>(aligned_alloc(SWEEP_ALIGN, max_bytes));
+    if (!buffer) return -1;
+    memset(buffer, 1, max_bytes);
+    alloc_trace.end();
+
+    std::vector<size_t> sizes;
+    for (size_t size = SWEEP_MIN_BYTES; size <= max_bytes; size *= 2) sizes.push_back(size);
+
+    const int big_core = get_biggest_core();
+    const std::vector<std::pair<const char*, std::vector<int>>> modes = {
+            {"1c", {big_core}},
+            {"cluster", sweep_cluster_cores()},
+    };
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    const CpuTopology& topo = get_cpu_topology();
+    BenchRecord record("ram_bandwidth_sweep", 0, "ms");
+    record.on_cores(modes[1].second).param("max_bytes", max_bytes).param("traffic_per_point", traffic)
+          .param("l1_bytes", topo.cache_size(1, big_core)).param("l2_bytes", topo.cache_size(2, big_core))
+          .param("l3_bytes", topo.cache_size(3, big_core));
+
+    const size_t kernel_count = sizeof(SWEEP_KERNELS) / sizeof(SWEEP_KERNELS[0]);
+    const size_t total_points = modes.size() * kernel_count * sizes.size();
+    size_t point = 0;
+    double total_seconds = 0.0;
+    double score_seconds = 0.0;
+
+    for (const auto& mode : modes) {
+        for (const auto& info : SWEEP_KERNELS) {
+            for (size_t size : sizes) {
+                // Every thread needs at least one full iteration of its slice
+                if (size < mode.second.size() * SWEEP_ALIGN) { ++point; continue; }
+                const unsigned long long passes = std::max<unsigned long long>(1, traffic / size);
+                double seconds = run_sweep_point(mode.second, buffer, size, info.kernel, passes);
+                total_seconds += seconds;
+
+                double gb_per_s = seconds > 0 ? static_cast<double>(info.touches) * size * passes / seconds / 1e9 : 0.0;
+                LOGI("Bandwidth sweep %-7s %-5s %8zu KB: %7.1f GB/s", mode.first, info.name, size >> 10, gb_per_s);
+                record.metric(std::string(info.name) + "_" + mode.first + "_" + sweep_size_label(size) + "_gb_s", gb_per_s);
+                if (gb_per_s > 0 && std::find(std::begin(SWEEP_SCORE_SIZES), std::end(SWEEP_SCORE_SIZES), size) != std::end(SWEEP_SCORE_SIZES)) {
+                    score_seconds += static_cast<double>(info.touches) * SWEEP_TRAFFIC_PER_POINT / (gb_per_s * 1e9);
+                }
+
+                update_progress(env, activity, updateProgressMethod, static_cast<float>(++point) / total_points);
+            }
+        }
+    }
+
+    free(buffer);
+    // Extrapolated per point from its bandwidth, so points whose passes were clamped to one are not skewed
+    record.result = static_cast<jlong>(score_seconds * 1000.0);
+    record.metric("measured_ms", static_cast<jlong>(total_seconds * 1000.0));
+    record_result(env, activity, record);
+    return record.result;
+}
+
+}
@@ -0,0 +1,307 @@
+#include "results.h"
+#include "utils.h"
+#include "topology.h"
+#include "sizing.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "preflight.h"
+#include "energy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/system_properties.h>
+#include <sys/utsname.h>
+
+static const char* RESULTS_FILE_NAME = "bench_results.jsonl";
+static const char* BUILD_PROPERTIES[] = {
+        "ro.product.manufacturer", "ro.product.model", "ro.soc.manufacturer", "ro.soc.model",
+        "ro.build.version.release", "ro.build.version.sdk", "ro.build.fingerprint",
+};
+
+static std::mutex g_results_mutex;
+static std::atomic<long long> g_run_id{0};
+
+// Process resource usage at the start of the current test (nativeBeginTestAccounting)
+struct TestAccounting {
+    bool started = false;
+    bool peak_reset = false;    // VmHWM was reset, so the peak belongs to this test alone
+    std::chrono::steady_clock::time_point start;
+    rusage usage{};
+    long long rss_bytes = 0;
+};
+static TestAccounting g_test_accounting;
+
+static long long epoch_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static std::string read_first_line(const std::string& path) {
+    std::ifstream f(path);
+    std::string line;
+    if (f.is_open()) std::getline(f, line);
+    return line;
+}
+
+static std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char ch : text) {
+        switch (ch) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+static std::string json_number(double value) {
+    if (!std::isfinite(value)) return "null";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+}
+
+// VmRSS / VmHWM from /proc/self/status in bytes, -1 if missing
+static long long proc_status_bytes(const char* key) {
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    const size_t key_length = strlen(key);
+    while (std::getline(f, line)) {
+        if (line.compare(0, key_length, key) == 0 && line.size() > key_length && line[key_length] == ':') {
+            return std::atoll(line.c_str() + key_length + 1) * 1024;
+        }
+    }
+    return -1;
+}
+
+static double timeval_ms(const timeval& tv) {
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+// Deltas of getrusage(RUSAGE_SELF) since the test started: every thread of the process, including
+// workers that have already exited. Involuntary switches point at preemption, major faults at reclaim.
+static std::string resources_snapshot() {
+    std::lock_guard<std::mutex> lock(g_results_mutex);
+    const TestAccounting& begin = g_test_accounting;
+    if (!begin.started) return "null";
+
+    rusage now{};
+    getrusage(RUSAGE_SELF, &now);
+    const double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin.start).count();
+    const double user_ms = timeval_ms(now.ru_utime) - timeval_ms(begin.usage.ru_utime);
+    const double system_ms = timeval_ms(now.ru_stime) - timeval_ms(begin.usage.ru_stime);
+    const long long peak_rss = proc_status_bytes("VmHWM");
+    const long long rss = proc_status_bytes("VmRSS");
+
+    LOGI("Resources: %.0f ms wall, user %.0f ms, system %.0f ms, %ld/%ld vol/invol switches, %ld major faults, peak RSS %lld MB",
+         wall_ms, user_ms, system_ms, now.ru_nvcsw - begin.usage.ru_nvcsw, now.ru_nivcsw - begin.usage.ru_nivcsw,
+         now.ru_majflt - begin.usage.ru_majflt, peak_rss >> 20);
+    return "{\"wall_ms\":" + json_number(wall_ms) +
+           ",\"user_ms\":" + json_number(user_ms) +
+           ",\"system_ms\":" + json_number(system_ms) +
+           ",\"cpu_utilization\":" + json_number(wall_ms > 0 ? (user_ms + system_ms) / wall_ms : 0.0) +
+           ",\"minor_faults\":" + std::to_string(now.ru_minflt - begin.usage.ru_minflt) +
+           ",\"major_faults\":" + std::to_string(now.ru_majflt - begin.usage.ru_majflt) +
+           ",\"voluntary_switches\":" + std::to_string(now.ru_nvcsw - begin.usage.ru_nvcsw) +
+           ",\"involuntary_switches\":" + std::to_string(now.ru_nivcsw - begin.usage.ru_nivcsw) +
+           ",\"rss_start_bytes\":" + std::to_string(begin.rss_bytes) +
+           ",\"rss_end_bytes\":" + std::to_string(rss) +
+           ",\"peak_rss_bytes\":" + std::to_string(peak_rss) +
+           ",\"peak_rss_per_test\":" + (begin.peak_reset ? "true" : "false") + "}";
+}
+
+static std::string json_pairs(const std::vector<std::pair<std::string, double>>& pairs) {
+    std::string out = "{";
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        out += (i ? "," : "") + json_string(pairs[i].first) + ":" + json_number(pairs[i].second);
+    }
+    return out + "}";
+}
+
+// Current frequency and governor of every online core
+static std::string cpufreq_snapshot() {
+    std::string out = "[";
+    bool first = true;
+    for (int cpu : get_cpu_topology().online) {
+        std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq";
+        std::string cur = read_first_line(dir + "/scaling_cur_freq");
+        out += (first ? "" : ",");
+        out += "{\"cpu\":" + std::to_string(cpu) +
+               ",\"cur_khz\":" + (cur.empty() ? "null" : json_number(std::atof(cur.c_str()))) +
+               ",\"governor\":" + json_string(read_first_line(dir + "/scaling_governor")) + "}";
+        first = false;
+    }
+    return out + "]";
+}
+
+// Every readable thermal zone in degrees Celsius (the kernel reports millidegrees)
+static std::string thermal_snapshot() {
+    std::string out = "{";
+    DIR* dir = opendir("/sys/class/thermal");
+    if (!dir) return out + "}";
+    bool first = true;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.rfind("thermal_zone", 0) != 0) continue;
+        std::string base = "/sys/class/thermal/" + name;
+        std::string temp = read_first_line(base + "/temp");
+        if (temp.empty()) continue;
+        std::string type = read_first_line(base + "/type");
+        out += (first ? "" : ",") + json_string(type.empty() ? name : type + "/" + name) + ":" +
+               json_number(std::atof(temp.c_str()) / 1000.0);
+        first = false;
+    }
+    closedir(dir);
+    return out + "}";
+}
+
+static std::string build_snapshot() {
+    std::string out = "{";
+    utsname uts{};
+    if (uname(&uts) == 0) {
+        out += "\"kernel\":" + json_string(std::string(uts.release) + " " + uts.version) +
+               ",\"arch\":" + json_string(uts.machine);
+    }
+    for (const char* property : BUILD_PROPERTIES) {
+        char value[PROP_VALUE_MAX] = {};
+        __system_property_get(property, value);
+        out += (out.size() > 1 ? "," : "") + json_string(property) + ":" + json_string(value);
+    }
+    return out + "}";
+}
+
+void record_result(JNIEnv* env, jobject activity, const BenchRecord& measured) {
+    BenchRecord record = measured;
+    attach_perf_metrics(record);
+    const EnergyReading energy = energy_read();
+    attach_energy_metrics(record, energy);
+
+    std::string cores = "[";
+    for (size_t i = 0; i < record.cores.size(); ++i) cores += (i ? "," : "") + std::to_string(record.cores[i]);
+    cores += "]";
+
+    DeviceResources res = read_device_resources();
+    std::string line = "{\"run_id\":" + std::to_string(g_run_id.load()) +
+                       ",\"timestamp_ms\":" + std::to_string(epoch_ms()) +
+                       ",\"profile\":" + json_string(run_profile_name()) +
+                       ",\"test\":" + json_string(record.test) +
+                       ",\"result\":" + std::to_string(static_cast<long long>(record.result)) +
+                       ",\"result_unit\":" + json_string(record.result_unit) +
+                       ",\"metrics\":" + json_pairs(record.metrics) +
+                       ",\"params\":" + json_pairs(record.params) +
+                       ",\"cores\":" + cores +
+                       ",\"cpufreq\":" + cpufreq_snapshot() +
+                       ",\"thermal_c\":" + thermal_snapshot() +
+                       ",\"memory\":{\"total_bytes\":" + std::to_string(res.mem_total) +
+                       ",\"available_bytes\":" + std::to_string(res.mem_available) +
+                       ",\"last_level_cache_bytes\":" + std::to_string(res.last_level_cache) + "}" +
+                       ",\"build\":" + build_snapshot() +
+                       ",\"resources\":" + resources_snapshot() +
+                       ",\"preflight\":" + last_preflight().to_json() +
+                       ",\"energy\":" + energy.to_json();
+    if (!record.driver.empty()) line += ",\"gpu_driver\":" + json_string(record.driver);
+    line += "}\n";
+
+    std::string path = get_files_dir_path(env, activity) + "/" + RESULTS_FILE_NAME;
+    std::lock_guard<std::mutex> lock(g_results_mutex);
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) {
+        LOGE("Results: cannot open %s", path.c_str());
+        return;
+    }
+    out << line;
+}
+
+extern "C" {
+
+// Starts a new run: every record written until the next call carries the same run_id
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeBeginResultRun(JNIEnv* /*env*/, jobject /*thiz*/) {
+    g_run_id = epoch_ms();
+    trace_begin_run();
+    preflight_begin_run();
+    LOGI("Results: run %lld", g_run_id.load());
+}
+
+// Start of a test: snapshot of process resource usage that every record until the next call is measured
+// against. Writing 5 to clear_refs resets VmHWM, so the peak RSS covers this test only when allowed.
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeBeginTestAccounting(JNIEnv* /*env*/, jobject /*thiz*/) {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    bool peak_reset = false;
+    if (clear_refs.is_open()) {
+        clear_refs << "5";
+        clear_refs.close();
+        peak_reset = !clear_refs.fail();
+    }
+
+    std::lock_guard<std::mutex> lock(g_results_mutex);
+    g_test_accounting.started = true;
+    g_test_accounting.peak_reset = peak_reset;
+    g_test_accounting.rss_bytes = proc_status_bytes("VmRSS");
+    getrusage(RUSAGE_SELF, &g_test_accounting.usage);
+    g_test_accounting.start = std::chrono::steady_clock::now();
+    energy_begin_test();
+}
+
+// End of a run: the phase timeline goes to <filesDir>/trace_<run_id>.json, for Perfetto or chrome://tracing
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeFinishResultRun(JNIEnv* env, jobject /*thiz*/, jobject activity) {
+    trace_write(get_files_dir_path(env, activity) + "/trace_" + std::to_string(g_run_id.load()) + ".json");
+    energy_end_run();
+}
+
+// Span measured on the Kotlin side; System.nanoTime() is CLOCK_MONOTONIC like the native events
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeTraceEvent(
+        JNIEnv* env, jobject /*thiz*/, jstring name, jlong start_ns, jlong end_ns) {
+    const char* chars = env->GetStringUTFChars(name, nullptr);
+    trace_complete(trace_intern(chars), static_cast<uint64_t>(start_ns), static_cast<uint64_t>(end_ns));
+    env->ReleaseStringUTFChars(name, chars);
+}
+
+// Record for a benchmark measured on the Kotlin side (LiteRT); metric names and values are parallel arrays
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRecordResult(
+        JNIEnv* env, jobject /*thiz*/, jobject activity, jstring test, jlong result, jstring unit,
+        jobjectArray metric_names, jdoubleArray metric_values) {
+
+    auto to_string = [env](jstring text) {
+        const char* chars = env->GetStringUTFChars(text, nullptr);
+        std::string value = chars;
+        env->ReleaseStringUTFChars(text, chars);
+        return value;
+    };
+
+    BenchRecord record(to_string(test), result, to_string(unit));
+    const jsize count = std::min(env->GetArrayLength(metric_names), env->GetArrayLength(metric_values));
+    std::vector<jdouble> values(count);
+    env->GetDoubleArrayRegion(metric_values, 0, count, values.data());
+    for (jsize i = 0; i < count; ++i) {
+        auto name = (jstring)env->GetObjectArrayElement(metric_names, i);
+        record.metric(to_string(name), values[i]);
+        env->DeleteLocalRef(name);
+    }
+    record_result(env, activity, record);
+}
+
+}
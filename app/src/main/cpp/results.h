@@ -0,0 +1,27 @@
+#pragma once
+#include <jni.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Structured result of one native benchmark, appended as a JSON line to <filesDir>/bench_results.jsonl
+// together with a snapshot of the run environment (cpufreq, governors, thermal zones, kernel and build).
+struct BenchRecord {
+    std::string test;
+    jlong result = 0;                   // the value handed back to Kotlin (extrapolated to the full profile)
+    std::string result_unit;            // "ms", "ns", ...
+    std::vector<std::pair<std::string, double>> metrics;   // derived throughput, e.g. gflops, mb_per_s
+    std::vector<std::pair<std::string, double>> params;    // problem size and settings
+    std::vector<int> cores;             // cores the workers were pinned to
+    std::string driver;                 // GPU name and driver version for the Vulkan tests
+
+    BenchRecord(std::string test_name, jlong value, std::string unit)
+            : test(std::move(test_name)), result(value), result_unit(std::move(unit)) {}
+
+    BenchRecord& metric(const std::string& name, double value) { metrics.emplace_back(name, value); return *this; }
+    BenchRecord& param(const std::string& name, double value) { params.emplace_back(name, value); return *this; }
+    BenchRecord& on_cores(const std::vector<int>& pinned) { cores = pinned; return *this; }
+    BenchRecord& on_core(int core) { cores.assign(1, core); return *this; }
+};
+
+void record_result(JNIEnv* env, jobject activity, const BenchRecord& record);
@@ -1,4 +1,5 @@
 #include <jni.h>
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -13,6 +14,23 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include "utils.h"
+#include "results.h"
+#include "energy.h"
+#include "trace.h"
+#include "sizing.h"
+#include "histogram.h"
+#include "contention.h"
+
+// Tail latency (worst of read/write/sync p99.9, in microseconds) of the last mixed random run
+static long long g_last_rom_tail_latency_us = -1;
+
+// Writes are synced in groups like this so writeback, and with it flash GC, happens inside the timed loop
+static const int ROM_RAND_SYNC_EVERY = 16;
+
+static inline uint64_t elapsed_ns(std::chrono::high_resolution_clock::time_point from,
+                                  std::chrono::high_resolution_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
 
 // Create file with random data
 bool create_random_test_file(const std::string& path, size_t size) {
@@ -54,14 +72,78 @@ bool create_random_test_file(const std::string& path, size_t size) {
     return true;
 }
 
+// Random 64 KB reads and writes on one core. The page cache is dropped at the start of every run
+// and the writes are synced in small groups, so the load keeps reaching the flash.
+class RomRandomLoad : public ContentionLoad {
+public:
+    explicit RomRandomLoad(std::string dir) : path_(std::move(dir) + "/mb_contention_test.bin") {}
+    ~RomRandomLoad() override {
+        if (fd_ >= 0) close(fd_);
+        if (file_size_ > 0) remove(path_.c_str());
+    }
+
+    const char* name() const override { return "rom_random"; }
+    const char* unit() const override { return "mb_s"; }
+    int max_cores() const override { return 1; }
+
+    bool prepare() override {
+        const std::string dir = path_.substr(0, path_.rfind('/'));
+        file_size_ = size_file_bytes(dir, 256ULL * 1024 * 1024, 32ULL * 1024 * 1024, BLOCK_SIZE);
+        TRACE_SCOPE("rom_create_file");
+        if (!create_random_test_file(path_, file_size_)) return false;
+        fd_ = open(path_.c_str(), O_RDWR);
+        if (fd_ < 0) {
+            LOGI("Contention storage load: open failed errno=%d", errno);
+            return false;
+        }
+        block_.resize(BLOCK_SIZE);
+        return true;
+    }
+
+    double run(const std::vector<int>& cores, const std::atomic<bool>& stop) override {
+        pin_to_core(cores[0]);
+        TRACE_SCOPE("contention_rom_random");
+        posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+        std::mt19937 gen(std::random_device{}());
+        std::uniform_int_distribution<int64_t> dist_block(0, static_cast<int64_t>(file_size_ / BLOCK_SIZE) - 1);
+        uint64_t bytes = 0;
+        for (int op = 0; !stop.load(std::memory_order_relaxed); ++op) {
+            ssize_t r = pread(fd_, block_.data(), BLOCK_SIZE, dist_block(gen) * static_cast<off_t>(BLOCK_SIZE));
+            block_[op % BLOCK_SIZE] ^= 0x5a;
+            ssize_t w = pwrite(fd_, block_.data(), BLOCK_SIZE, dist_block(gen) * static_cast<off_t>(BLOCK_SIZE));
+            if (r != BLOCK_SIZE || w != BLOCK_SIZE) {
+                LOGI("Contention storage load: I/O error errno=%d", errno);
+                break;
+            }
+            bytes += 2 * BLOCK_SIZE;
+            if (op % 16 == 15) fdatasync(fd_);
+        }
+        fdatasync(fd_);
+        return bytes / 1e6;
+    }
+
+private:
+    static constexpr int BLOCK_SIZE = 64 * 1024;
+    std::string path_;
+    size_t file_size_ = 0;
+    int fd_ = -1;
+    std::vector<uint8_t> block_;
+};
+
+std::unique_ptr<ContentionLoad> make_rom_random_load(const std::string& dir) {
+    return std::make_unique<RomRandomLoad>(dir);
+}
+
 extern "C" {
 
 JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchmark(
         JNIEnv* env, jobject /*thiz*/, jobject activity) {
 
-    const size_t file_size = 500ULL * 1024ULL * 1024ULL; // 500 MB
+    const size_t full_file_size = 500ULL * 1024ULL * 1024ULL; // 500 MB
     const int block_size = 64 * 1024; // 64 KB
+    const std::string filesDir = get_files_dir_path(env, activity);
+    const size_t file_size = size_file_bytes(filesDir, full_file_size, 64ULL * 1024ULL * 1024ULL, block_size);
     const int64_t iterations = static_cast<int64_t>(file_size / block_size);
 
     int big_core = get_biggest_core();
@@ -70,12 +152,14 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
     jclass activityClass = env->GetObjectClass(activity);
     jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
 
-    std::string filePath = get_files_dir_path(env, activity) + "/mb_mixed_rw_test.bin";
+    std::string filePath = filesDir + "/mb_mixed_rw_test.bin";
 
     // Create file with random data
+    TraceScope create_trace("rom_create_file");
     if (!create_random_test_file(filePath, file_size)) {
         return -1;
     }
+    create_trace.end();
 
     // Open file for write/read
     int fd = open(filePath.c_str(), O_RDWR);
@@ -92,6 +176,7 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
         remove(filePath.c_str());
         return -1;
     }
+    prefault_pages(block, block_size);
 
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -101,14 +186,23 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
     const int total_progress_updates = 100;
     const int64_t progress_step = std::max<int64_t>(1, iterations / total_progress_updates);
 
+    // Per-operation latencies; a single GC stall is invisible in the total time
+    LatencyHistogram read_latency;
+    LatencyHistogram write_latency;
+    LatencyHistogram sync_latency;      // fdatasync after every ROM_RAND_SYNC_EVERY writes
+    g_last_rom_tail_latency_us = -1;
+
     volatile uint64_t checksum = 0;
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
 
     for (int64_t i = 0; i < iterations; ++i) {
         // Every time choose random block for read
         int64_t read_block = dist_offset(gen);
         off_t read_offset = read_block * static_cast<off_t>(block_size);
+        auto read_start = std::chrono::high_resolution_clock::now();
         ssize_t r = pread(fd, block, block_size, read_offset);
+        read_latency.record(elapsed_ns(read_start, std::chrono::high_resolution_clock::now()));
         if (r == -1 || r != block_size) {
             LOGI("Read error (errno: %d) read=%zd expected=%d", errno, r, block_size);
             close(fd);
@@ -128,7 +222,9 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
             block[j] = static_cast<uint8_t>(dist_value(gen));
         }
 
+        auto write_start = std::chrono::high_resolution_clock::now();
         ssize_t w = pwrite(fd, block, block_size, write_offset);
+        write_latency.record(elapsed_ns(write_start, std::chrono::high_resolution_clock::now()));
         if (w == -1 || w != block_size) {
             LOGI("Write error (errno: %d) wrote=%zd expected=%d", errno, w, block_size);
             close(fd);
@@ -137,13 +233,19 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
             return -1;
         }
 
+        if (i % ROM_RAND_SYNC_EVERY == ROM_RAND_SYNC_EVERY - 1) {
+            auto sync_start = std::chrono::high_resolution_clock::now();
+            if (fdatasync(fd) != 0) LOGI("fdatasync failed (errno: %d)", errno);
+            sync_latency.record(elapsed_ns(sync_start, std::chrono::high_resolution_clock::now()));
+        }
+
         if ((i % progress_step) == 0 && i > 0) {
             float progress = static_cast<float>(i) / static_cast<float>(iterations);
             update_progress(env, activity, updateProgressMethod, progress);
         }
     }
 
-    // Force sync data on disk
+    // Force the last partial group on disk
     if (fdatasync(fd) != 0) {
         LOGI("fdatasync failed (errno: %d)", errno);
     }
@@ -152,13 +254,47 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomMixedRandomBenchm
     update_progress(env, activity, updateProgressMethod, 1.0f);
 
     auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
     long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
     LOGV("Mixed RW Checksum: %" PRIu64, checksum);
+    log_latency_histogram("Mixed RW pread latency", read_latency);
+    log_latency_histogram("Mixed RW pwrite latency", write_latency);
+    log_latency_histogram("Mixed RW fdatasync latency", sync_latency);
+
+    uint64_t tail_ns = std::max({read_latency.percentile(99.9), write_latency.percentile(99.9), sync_latency.percentile(99.9)});
+    g_last_rom_tail_latency_us = std::max<long long>(1, static_cast<long long>(tail_ns / 1000));
+    LOGI("Mixed RW tail latency (p99.9): %lld us", g_last_rom_tail_latency_us);
+
+    const long full_duration_ms = scale_to_full_work(duration_ms, file_size, full_file_size);
+    record_result(env, activity, BenchRecord("rom_rand_ops", full_duration_ms, "ms")
+            .on_core(big_core).metric("measured_ms", duration_ms)
+            .metric("mb_per_s", duration_ms > 0 ? 2.0 * iterations * block_size / (1024.0 * 1024.0) / (duration_ms / 1000.0) : 0.0)
+            .metric("read_p50_us", read_latency.percentile(50.0) / 1000.0)
+            .metric("read_p99_us", read_latency.percentile(99.0) / 1000.0)
+            .metric("read_p999_us", read_latency.percentile(99.9) / 1000.0)
+            .metric("read_max_us", read_latency.max_ns / 1000.0)
+            .metric("write_p50_us", write_latency.percentile(50.0) / 1000.0)
+            .metric("write_p99_us", write_latency.percentile(99.0) / 1000.0)
+            .metric("write_p999_us", write_latency.percentile(99.9) / 1000.0)
+            .metric("write_max_us", write_latency.max_ns / 1000.0)
+            .metric("sync_p50_us", sync_latency.percentile(50.0) / 1000.0)
+            .metric("sync_p99_us", sync_latency.percentile(99.0) / 1000.0)
+            .metric("sync_max_us", sync_latency.max_ns / 1000.0)
+            .metric("tail_p999_us", g_last_rom_tail_latency_us)
+            .param("file_bytes", file_size).param("block_bytes", block_size).param("sync_every", ROM_RAND_SYNC_EVERY));
+
     close(fd);
     remove(filePath.c_str());
     delete[] block;
-    return duration_ms;
+    return full_duration_ms;
+}
+
+// Tail of the rom_rand_ops run that just finished; part of the same step's score
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeGetRomRandomTailLatencyUs(
+        JNIEnv* /*env*/, jobject /*thiz*/) {
+    return g_last_rom_tail_latency_us;
 }
 
 }
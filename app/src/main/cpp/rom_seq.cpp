@@ -12,10 +12,18 @@
 #include <android/log.h>
 #include <sys/system_properties.h>
 #include "utils.h"
+#include "results.h"
+#include "energy.h"
+#include "trace.h"
+#include "sizing.h"
+
+static const size_t ROM_SEQ_FULL_FILE_SIZE = 500 * 1024 * 1024; // 500 MB
+static const size_t ROM_SEQ_MIN_FILE_SIZE = 64 * 1024 * 1024;
 
 extern "C" {
 
 bool create_test_file(const std::string& path, size_t size) {
+    TRACE_SCOPE("rom_create_file");
     std::ofstream file(path, std::ios::binary | std::ios::trunc);
     if (!file) return false;
 
@@ -38,8 +46,9 @@ JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialWriteBenchmark(
         JNIEnv* env, jobject /*thiz*/, jobject activity) {
 
-    const size_t file_size = 500 * 1024 * 1024; // 500 MB
+    const std::string filesDir = get_files_dir_path(env, activity);
     const int block_size = 4 * 1024 * 1024; // 4 MB
+    const size_t file_size = size_file_bytes(filesDir, ROM_SEQ_FULL_FILE_SIZE, ROM_SEQ_MIN_FILE_SIZE, block_size);
     const int iterations = file_size / block_size;
     int big_core = get_biggest_core();
     pin_to_core(big_core);
@@ -47,8 +56,9 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialWriteBe
     jclass activityClass = env->GetObjectClass(activity);
     jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
 
-    std::string filePath = get_files_dir_path(env, activity) + "/mb_seq_write_test.bin";
+    std::string filePath = filesDir + "/mb_seq_write_test.bin";
 
+    TraceScope prealloc_trace("rom_create_file");
     std::ofstream pre_alloc_file(filePath, std::ios::binary | std::ios::trunc);
     if (!pre_alloc_file) {
         return -1;
@@ -58,6 +68,7 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialWriteBe
         pre_alloc_file.write(empty_block.data(), block_size);
     }
     pre_alloc_file.close();
+    prealloc_trace.end();
 
     int fd = open(filePath.c_str(), O_WRONLY);
     if (fd < 0) {
@@ -70,9 +81,10 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialWriteBe
     std::uniform_int_distribution<uint16_t> dist_value(0, 255);
 
     const int total_progress_updates = 100;
-    const int64_t progress_step = iterations / total_progress_updates;
+    const int64_t progress_step = std::max<int64_t>(1, iterations / total_progress_updates);
 
     std::vector<uint8_t> block(block_size);
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
 
     for (int i = 0; i < iterations; ++i) {
@@ -96,17 +108,24 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialWriteBe
     asm volatile("" : : : "memory");
     update_progress(env, activity, updateProgressMethod, 1.0f);
     auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
 
     remove(filePath.c_str());
-    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    jlong full_ms = scale_to_full_work(ms, file_size, ROM_SEQ_FULL_FILE_SIZE);
+    record_result(env, activity, BenchRecord("rom_seq_write", full_ms, "ms")
+            .on_core(big_core).metric("mb_per_s", ms > 0 ? file_size / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0)
+            .metric("measured_ms", ms).param("file_bytes", file_size).param("block_bytes", block_size));
+    return full_ms;
 }
 
 JNIEXPORT jlong JNICALL
 Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialReadBenchmark(
         JNIEnv* env, jobject /*thiz*/, jobject activity) {
 
-    const size_t file_size = 500 * 1024 * 1024; // 500 MB
+    const std::string filesDir = get_files_dir_path(env, activity);
     const int block_size = 4 * 1024 * 1024; // 4 MB
+    const size_t file_size = size_file_bytes(filesDir, ROM_SEQ_FULL_FILE_SIZE, ROM_SEQ_MIN_FILE_SIZE, block_size);
     const int iterations = file_size / block_size;
     int big_core = get_biggest_core();
     pin_to_core(big_core);
@@ -114,7 +133,7 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialReadBen
     jclass activityClass = env->GetObjectClass(activity);
     jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
 
-    std::string filePath = get_files_dir_path(env, activity) + "/mb_seq_read_test.bin";
+    std::string filePath = filesDir + "/mb_seq_read_test.bin";
 
     if (!create_test_file(filePath, file_size)) {
         return -1;
@@ -144,12 +163,14 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialReadBen
         return -1;
     }
     block = static_cast<uint8_t*>(aligned_block_ptr);
+    prefault_pages(block, block_size);
 
     const int total_progress_updates = 100;
-    const int64_t progress_step = iterations / total_progress_updates;
+    const int64_t progress_step = std::max<int64_t>(1, iterations / total_progress_updates);
 
     // Make checksum volatile to prevent optimization
     volatile uint64_t checksum = 0;
+    EnergyRegion energy;
     auto start = std::chrono::high_resolution_clock::now();
 
     for (int i = 0; i < iterations; ++i) {
@@ -186,12 +207,17 @@ Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomSequentialReadBen
 
     update_progress(env, activity, updateProgressMethod, 1.0f);
     auto end = std::chrono::high_resolution_clock::now();
+    energy.stop();
     long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
     close(fd);
     free(aligned_block_ptr);
     remove(filePath.c_str());
-    return duration_ms;
+    jlong full_ms = scale_to_full_work(duration_ms, file_size, ROM_SEQ_FULL_FILE_SIZE);
+    record_result(env, activity, BenchRecord("rom_seq_read", full_ms, "ms")
+            .on_core(big_core).metric("mb_per_s", duration_ms > 0 ? file_size / (1024.0 * 1024.0) / (duration_ms / 1000.0) : 0.0)
+            .metric("measured_ms", duration_ms).param("file_bytes", file_size).param("block_bytes", block_size));
+    return full_ms;
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include <jni.h>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <random>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "utils.h"
+#include "results.h"
+#include "energy.h"
+#include "histogram.h"
+
+// Database WAL model: small records appended to a log, every commit made durable with fdatasync.
+
+static const size_t WAL_MIN_RECORD = 512;
+static const size_t WAL_MAX_RECORD = 16 * 1024;
+static const int WAL_QD1_COMMITS = 1000;
+static const int WAL_GROUP_WRITERS = 4;
+static const int WAL_GROUP_COMMITS_PER_WRITER = 500;
+
+// Record sizes are log-uniform between 512 B and 16 KB, rounded to 512 B like a page-aligned WAL frame
+static std::vector<size_t> make_record_sizes(size_t count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist_log(std::log2(double(WAL_MIN_RECORD)), std::log2(double(WAL_MAX_RECORD)));
+    std::vector<size_t> sizes(count);
+    for (auto& s : sizes) {
+        auto bytes = static_cast<size_t>(std::exp2(dist_log(gen)));
+        s = std::min(WAL_MAX_RECORD, std::max(WAL_MIN_RECORD, (bytes + 511) & ~size_t(511)));
+    }
+    return sizes;
+}
+
+static inline uint64_t elapsed_ns(std::chrono::high_resolution_clock::time_point from,
+                                  std::chrono::high_resolution_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+static bool write_all(int fd, const uint8_t* data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t w = pwrite(fd, data, size, offset);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += w; size -= static_cast<size_t>(w); offset += w;
+    }
+    return true;
+}
+
+// Shared log state for the group commit phase. One writer at a time becomes the leader,
+// takes every pending record, writes them with a single pwrite and makes them durable with one fdatasync.
+struct GroupCommitLog {
+    int fd = -1;
+    off_t tail = 0;
+    std::mutex mutex;
+    std::condition_variable durable_cv;
+    std::vector<uint8_t> pending;
+    uint64_t next_seq = 0;
+    uint64_t durable_seq = 0;
+    bool leader_active = false;
+    std::atomic<bool> failed{false};
+    uint64_t batches = 0;
+};
+
+// Returns false on I/O error
+static bool group_commit(GroupCommitLog& log, const uint8_t* record, size_t size) {
+    std::unique_lock<std::mutex> lock(log.mutex);
+    log.pending.insert(log.pending.end(), record, record + size);
+    uint64_t my_seq = ++log.next_seq;
+
+    while (log.durable_seq < my_seq && !log.failed) {
+        if (log.leader_active) {
+            log.durable_cv.wait(lock);
+            continue;
+        }
+
+        // Become the leader for everything queued so far
+        log.leader_active = true;
+        std::vector<uint8_t> batch;
+        batch.swap(log.pending);
+        uint64_t batch_seq = log.next_seq;
+        off_t offset = log.tail;
+        log.tail += static_cast<off_t>(batch.size());
+        lock.unlock();
+
+        bool ok = write_all(log.fd, batch.data(), batch.size(), offset) && fdatasync(log.fd) == 0;
+
+        lock.lock();
+        if (!ok) {
+            LOGE("WAL group commit failed (errno: %d)", errno);
+            log.failed = true;
+        } else {
+            log.durable_seq = batch_seq;
+            log.batches++;
+        }
+        log.leader_active = false;
+        log.durable_cv.notify_all();
+    }
+    return !log.failed;
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunRomWalSyncBenchmark(
+        JNIEnv* env, jobject /*thiz*/, jobject activity) {
+
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID updateProgressMethod = env->GetMethodID(activityClass, "updateBenchmarkProgress", "(F)V");
+
+    std::string filePath = get_files_dir_path(env, activity) + "/mb_wal_test.bin";
+
+    int fd = open(filePath.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOGE("WAL: failed to create log file (errno: %d)", errno);
+        return -1;
+    }
+
+    std::vector<uint8_t> payload(WAL_MAX_RECORD);
+    std::mt19937 gen(0x57A1u);
+    for (auto& b : payload) b = static_cast<uint8_t>(gen());
+
+    const int group_total = WAL_GROUP_WRITERS * WAL_GROUP_COMMITS_PER_WRITER;
+    const int total_commits = WAL_QD1_COMMITS + group_total;
+
+    int big_core = get_biggest_core();
+    pin_to_core(big_core);
+
+    // --- Phase 1: queue depth 1, every record followed by its own fdatasync ---
+    std::vector<size_t> qd1_sizes = make_record_sizes(WAL_QD1_COMMITS, 1);
+    LatencyHistogram qd1_latency;
+    off_t tail = 0;
+
+    EnergyRegion qd1_energy;
+    auto qd1_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < WAL_QD1_COMMITS; ++i) {
+        auto commit_start = std::chrono::high_resolution_clock::now();
+        if (!write_all(fd, payload.data(), qd1_sizes[i], tail) || fdatasync(fd) != 0) {
+            LOGE("WAL QD1 commit failed (errno: %d)", errno);
+            close(fd);
+            remove(filePath.c_str());
+            return -1;
+        }
+        qd1_latency.record(elapsed_ns(commit_start, std::chrono::high_resolution_clock::now()));
+        tail += static_cast<off_t>(qd1_sizes[i]);
+
+        if (i % 10 == 0) {
+            update_progress(env, activity, updateProgressMethod, static_cast<float>(i) / total_commits);
+        }
+    }
+    auto qd1_end = std::chrono::high_resolution_clock::now();
+    qd1_energy.stop();
+
+    // --- Phase 2: group commit across several writer threads ---
+    GroupCommitLog log;
+    log.fd = fd;
+    log.tail = tail;
+
+    std::vector<int> perf_cores = get_performance_cores();
+    std::vector<LatencyHistogram> writer_latency(WAL_GROUP_WRITERS);
+    std::atomic<int> completed{0};
+    std::vector<std::thread> writers;
+    writers.reserve(WAL_GROUP_WRITERS);
+
+    EnergyRegion group_energy;
+    auto group_start = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < WAL_GROUP_WRITERS; ++t) {
+        int target_core = perf_cores[t % perf_cores.size()];
+        writers.emplace_back([&, t, target_core]() {
+            pin_to_core(target_core);
+            std::vector<size_t> sizes = make_record_sizes(WAL_GROUP_COMMITS_PER_WRITER, 100 + t);
+            for (int i = 0; i < WAL_GROUP_COMMITS_PER_WRITER; ++i) {
+                auto commit_start = std::chrono::high_resolution_clock::now();
+                if (!group_commit(log, payload.data(), sizes[i])) return;
+                writer_latency[t].record(elapsed_ns(commit_start, std::chrono::high_resolution_clock::now()));
+                completed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    while (completed.load(std::memory_order_relaxed) < group_total && !log.failed) {
+        float progress = static_cast<float>(WAL_QD1_COMMITS + completed.load(std::memory_order_relaxed)) / total_commits;
+        update_progress(env, activity, updateProgressMethod, progress);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (auto& w : writers) w.join();
+    auto group_end = std::chrono::high_resolution_clock::now();
+    group_energy.stop();
+
+    close(fd);
+    remove(filePath.c_str());
+
+    if (log.failed) return -1;
+    update_progress(env, activity, updateProgressMethod, 1.0f);
+
+    LatencyHistogram group_latency;
+    for (const auto& h : writer_latency) group_latency.merge(h);
+
+    double qd1_s = std::chrono::duration<double>(qd1_end - qd1_start).count();
+    double group_s = std::chrono::duration<double>(group_end - group_start).count();
+    LOGI("WAL QD1: %.1f commits/s", WAL_QD1_COMMITS / qd1_s);
+    log_latency_histogram("WAL QD1 commit latency", qd1_latency);
+    LOGI("WAL group commit (%d writers): %.1f commits/s, %.1f records per fdatasync",
+         WAL_GROUP_WRITERS, group_total / group_s,
+         log.batches ? static_cast<double>(group_total) / log.batches : 0.0);
+    log_latency_histogram("WAL group commit latency", group_latency);
+
+    jlong ms = std::chrono::duration_cast<std::chrono::milliseconds>((qd1_end - qd1_start) + (group_end - group_start)).count();
+    record_result(env, activity, BenchRecord("rom_wal_sync", ms, "ms")
+            .on_core(big_core)
+            .metric("qd1_commits_per_s", WAL_QD1_COMMITS / qd1_s)
+            .metric("qd1_p99_us", qd1_latency.percentile(99.0) / 1000.0)
+            .metric("group_commits_per_s", group_total / group_s)
+            .metric("group_p99_us", group_latency.percentile(99.0) / 1000.0)
+            .metric("records_per_fdatasync", log.batches ? static_cast<double>(group_total) / log.batches : 0.0)
+            .param("qd1_commits", WAL_QD1_COMMITS).param("group_writers", WAL_GROUP_WRITERS)
+            .param("group_commits_per_writer", WAL_GROUP_COMMITS_PER_WRITER));
+    return ms;
+}
+
+}
@@ -0,0 +1,125 @@
+#include "sizing.h"
+#include "utils.h"
+#include "topology.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <sys/statvfs.h>
+#include <sys/sysinfo.h>
+
+static std::atomic<int> g_run_profile{static_cast<int>(RunProfile::FULL)};
+
+RunProfile get_run_profile() {
+    return static_cast<RunProfile>(g_run_profile.load());
+}
+
+const char* run_profile_name() {
+    return get_run_profile() == RunProfile::QUICK ? "quick" : "full";
+}
+
+// MemAvailable from /proc/meminfo (kB), 0 if the kernel does not report it
+static size_t read_mem_available() {
+    std::ifstream f("/proc/meminfo");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.rfind("MemAvailable:", 0) != 0) continue;
+        std::istringstream ss(line.substr(13));
+        size_t kb = 0;
+        ss >> kb;
+        return kb * 1024;
+    }
+    return 0;
+}
+
+DeviceResources read_device_resources() {
+    DeviceResources res;
+    struct sysinfo info{};
+    if (sysinfo(&info) == 0) {
+        res.mem_total = static_cast<size_t>(info.totalram) * info.mem_unit;
+        res.mem_available = static_cast<size_t>(info.freeram + info.bufferram) * info.mem_unit;
+    }
+    if (size_t available = read_mem_available()) res.mem_available = available;
+
+    const CpuTopology& topo = get_cpu_topology();
+    for (int cpu : topo.online) {
+        for (int level = 3; level >= 2; --level) {
+            size_t size = topo.cache_size(level, cpu);
+            if (size > 0) {
+                res.last_level_cache = std::max(res.last_level_cache, size);
+                break;
+            }
+        }
+    }
+    return res;
+}
+
+size_t free_disk_bytes(const std::string& dir) {
+    struct statvfs st{};
+    if (statvfs(dir.c_str(), &st) != 0) return 0;
+    return static_cast<size_t>(st.f_bavail) * st.f_frsize;
+}
+
+static size_t clamp_working_set(size_t full_bytes, size_t min_bytes, size_t limit, size_t align) {
+    size_t size = full_bytes;
+    if (get_run_profile() == RunProfile::QUICK) size /= SIZING_QUICK_DIVISOR;
+    if (limit > 0) size = std::min(size, limit);
+    size = std::max(size, std::min(min_bytes, full_bytes));
+    align = std::max<size_t>(1, align);
+    return std::max(align, size / align * align);
+}
+
+size_t size_memory_bytes(size_t full_bytes, size_t min_bytes, size_t align) {
+    DeviceResources res = read_device_resources();
+    size_t size = clamp_working_set(full_bytes, min_bytes, res.mem_available / 4, align);
+    if (size != full_bytes) {
+        LOGI("Sizing (%s): %zu MB buffer instead of %zu MB, %zu MB available", run_profile_name(),
+             size >> 20, full_bytes >> 20, res.mem_available >> 20);
+    }
+    return size;
+}
+
+size_t size_file_bytes(const std::string& dir, size_t full_bytes, size_t min_bytes, size_t align) {
+    size_t free_bytes = free_disk_bytes(dir);
+    size_t size = clamp_working_set(full_bytes, min_bytes, free_bytes / 4, align);
+    if (size != full_bytes) {
+        LOGI("Sizing (%s): %zu MB file instead of %zu MB, %zu MB free", run_profile_name(),
+             size >> 20, full_bytes >> 20, free_bytes >> 20);
+    }
+    return size;
+}
+
+long long size_work(long long full_work, long long min_work) {
+    if (get_run_profile() != RunProfile::QUICK) return full_work;
+    return std::min(full_work, std::max(min_work, full_work / SIZING_QUICK_DIVISOR));
+}
+
+long long work_for_min_duration(jlong elapsed, long long actual_work, long long granularity) {
+    if (get_run_profile() == RunProfile::QUICK || elapsed < 0 || actual_work <= 0) return actual_work;
+    if (elapsed >= SIZING_MIN_MEASURED_MS) return actual_work;
+    granularity = std::max(1LL, granularity);
+    const long long cap = actual_work * SIZING_MAX_WORK_FACTOR;
+    // A 0 ms run only says the work is too small to time; take the cap
+    long long work = elapsed > 0 ? static_cast<long long>(static_cast<double>(actual_work) * SIZING_MIN_MEASURED_MS / elapsed) : cap;
+    work = std::min(cap, (work + granularity - 1) / granularity * granularity);
+    LOGI("Sizing: %lld ms measured for %lld work items, rerunning with %lld", static_cast<long long>(elapsed),
+         actual_work, work);
+    return work;
+}
+
+jlong scale_to_full_work(jlong elapsed, double actual_work, double full_work) {
+    if (elapsed < 0 || actual_work <= 0 || actual_work == full_work) return elapsed;
+    return static_cast<jlong>(static_cast<double>(elapsed) * full_work / actual_work + 0.5);
+}
+
+extern "C" {
+
+// 0 = quick, 1 = full; applies to every benchmark started afterwards
+JNIEXPORT void JNICALL
+Java_com_komarudude_materialbench_ui_BenchActivity_nativeSetRunProfile(JNIEnv* /*env*/, jobject /*thiz*/, jint profile) {
+    g_run_profile = profile == static_cast<int>(RunProfile::QUICK) ? static_cast<int>(RunProfile::QUICK)
+                                                                     : static_cast<int>(RunProfile::FULL);
+    LOGI("Run profile: %s", run_profile_name());
+}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <jni.h>
+#include <cstddef>
+#include <string>
+
+// Problem sizing. The FULL profile is the reference workload every score is defined on; QUICK
+// (CI smoke runs) divides the work by SIZING_QUICK_DIVISOR. Working sets are also clamped to what
+// the device can hold: a quarter of MemAvailable for buffers, a quarter of the free space for files.
+// Entry points extrapolate their time back to the full workload, so the Kotlin scoring is unchanged.
+
+enum class RunProfile { QUICK = 0, FULL = 1 };
+
+static const int SIZING_QUICK_DIVISOR = 8;
+// FULL profile floor for the timed CPU loops (math, integer, sgemm): a run that measured less is
+// repeated with proportionally more work, capped at SIZING_MAX_WORK_FACTOR times the reference
+static const long long SIZING_MIN_MEASURED_MS = 2000;
+static const long long SIZING_MAX_WORK_FACTOR = 64;
+
+RunProfile get_run_profile();
+const char* run_profile_name();
+
+struct DeviceResources {
+    size_t mem_total = 0;
+    size_t mem_available = 0;
+    size_t last_level_cache = 0;    // largest data/unified cache seen by any core
+};
+
+DeviceResources read_device_resources();
+size_t free_disk_bytes(const std::string& dir);
+
+// Buffer of full_bytes in the full profile, scaled for quick and clamped to memory; never below
+// min_bytes, rounded down to a multiple of align
+size_t size_memory_bytes(size_t full_bytes, size_t min_bytes, size_t align);
+// Same for a file created in dir, clamped to the free space of its filesystem
+size_t size_file_bytes(const std::string& dir, size_t full_bytes, size_t min_bytes, size_t align);
+// Iteration / pass count: full_work, or full_work / SIZING_QUICK_DIVISOR (at least min_work) in quick
+long long size_work(long long full_work, long long min_work = 1);
+// Work for a rerun that lasts about SIZING_MIN_MEASURED_MS, given elapsed ms for actual_work;
+// a multiple of granularity, or actual_work itself in quick, after a failure or if the run was long enough
+long long work_for_min_duration(jlong elapsed, long long actual_work, long long granularity = 1);
+
+// Time measured for actual_work extrapolated linearly to full_work
+jlong scale_to_full_work(jlong elapsed, double actual_work, double full_work);
@@ -0,0 +1,203 @@
+#include "topology.h"
+#include "utils.h"
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+static const std::string SYS_CPU = "/sys/devices/system/cpu";
+
+static bool read_line(const std::string& path, std::string& out) {
+    std::ifstream f(path);
+    if (!f.is_open()) return false;
+    std::getline(f, out);
+    return true;
+}
+
+static long read_long(const std::string& path, long fallback) {
+    std::string line;
+    if (!read_line(path, line)) return fallback;
+    try {
+        return std::stol(line);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// Cache sizes are written as "32K", "1024K" or "8M"
+static size_t parse_size(const std::string& text) {
+    size_t value = 0;
+    size_t i = 0;
+    while (i < text.size() && text[i] >= '0' && text[i] <= '9') value = value * 10 + (text[i++] - '0');
+    if (i < text.size()) {
+        if (text[i] == 'K' || text[i] == 'k') value *= 1024;
+        else if (text[i] == 'M' || text[i] == 'm') value *= 1024 * 1024;
+    }
+    return value;
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (...) {
+            // ignore malformed entries
+        }
+    }
+    return cpus;
+}
+
+static std::vector<int> read_cpu_list(const std::string& path) {
+    std::string line;
+    return read_line(path, line) ? parse_cpu_list(line) : std::vector<int>();
+}
+
+static std::vector<CpuCache> read_caches(int cpu) {
+    std::vector<CpuCache> caches;
+    for (int index = 0;; ++index) {
+        std::string dir = SYS_CPU + "/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(index);
+        CpuCache cache;
+        cache.level = static_cast<int>(read_long(dir + "/level", -1));
+        if (cache.level < 0) break;
+        read_line(dir + "/type", cache.type);
+        std::string size;
+        if (read_line(dir + "/size", size)) cache.size_bytes = parse_size(size);
+        cache.line_size = static_cast<size_t>(read_long(dir + "/coherency_line_size", 0));
+        cache.shared_cpus = read_cpu_list(dir + "/shared_cpu_list");
+        caches.push_back(cache);
+    }
+    return caches;
+}
+
+// Ranking used to order clusters: cpu_capacity when the kernel exposes it, max frequency otherwise
+static long core_strength(const CpuCore& core) {
+    return core.capacity > 0 ? core.capacity : core.max_freq_khz;
+}
+
+static long cluster_strength(const CpuCluster& cluster) {
+    return cluster.capacity > 0 ? cluster.capacity : cluster.max_freq_khz;
+}
+
+static void discover(CpuTopology& topo) {
+    std::vector<int> possible = read_cpu_list(SYS_CPU + "/possible");
+    topo.online = read_cpu_list(SYS_CPU + "/online");
+    if (topo.online.empty()) {
+        unsigned int n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < n; ++cpu) topo.online.push_back(static_cast<int>(cpu));
+    }
+    int max_cpu = 0;
+    for (int cpu : possible) max_cpu = std::max(max_cpu, cpu);
+    for (int cpu : topo.online) max_cpu = std::max(max_cpu, cpu);
+
+    topo.cores.resize(max_cpu + 1);
+    for (int cpu = 0; cpu <= max_cpu; ++cpu) {
+        CpuCore& core = topo.cores[cpu];
+        std::string dir = SYS_CPU + "/cpu" + std::to_string(cpu);
+        core.id = cpu;
+        core.online = std::find(topo.online.begin(), topo.online.end(), cpu) != topo.online.end();
+        core.max_freq_khz = read_long(dir + "/cpufreq/cpuinfo_max_freq", 0);
+        core.capacity = read_long(dir + "/cpu_capacity", 0);
+        core.smt_siblings = read_cpu_list(dir + "/topology/thread_siblings_list");
+        if (core.smt_siblings.empty()) core.smt_siblings.push_back(cpu);
+        core.caches = read_caches(cpu);
+    }
+
+    // Clusters: cpufreq policy (related_cpus) first, then the cluster/package topology,
+    // then equal strength; offline CPUs are left out of every cluster
+    for (int cpu : topo.online) {
+        CpuCore& core = topo.cores[cpu];
+        if (core.cluster >= 0) continue;
+
+        std::string dir = SYS_CPU + "/cpu" + std::to_string(cpu);
+        std::vector<int> members = read_cpu_list(dir + "/cpufreq/related_cpus");
+        if (members.empty()) members = read_cpu_list(dir + "/topology/cluster_cpus_list");
+        if (members.empty()) {
+            for (int other : topo.online) {
+                if (core_strength(topo.cores[other]) == core_strength(core)) members.push_back(other);
+            }
+        }
+
+        CpuCluster cluster;
+        for (int member : members) {
+            if (member > max_cpu || !topo.cores[member].online || topo.cores[member].cluster >= 0) continue;
+            cluster.cpus.push_back(member);
+        }
+        if (std::find(cluster.cpus.begin(), cluster.cpus.end(), cpu) == cluster.cpus.end()) cluster.cpus.push_back(cpu);
+        for (int member : cluster.cpus) {
+            cluster.max_freq_khz = std::max(cluster.max_freq_khz, topo.cores[member].max_freq_khz);
+            cluster.capacity = std::max(cluster.capacity, topo.cores[member].capacity);
+            topo.cores[member].cluster = 0;
+        }
+        topo.clusters.push_back(cluster);
+    }
+
+    std::stable_sort(topo.clusters.begin(), topo.clusters.end(), [](const CpuCluster& a, const CpuCluster& b) {
+        return cluster_strength(a) < cluster_strength(b);
+    });
+    for (size_t c = 0; c < topo.clusters.size(); ++c) {
+        for (int cpu : topo.clusters[c].cpus) topo.cores[cpu].cluster = static_cast<int>(c);
+    }
+
+    for (size_t c = 0; c < topo.clusters.size(); ++c) {
+        const CpuCluster& cluster = topo.clusters[c];
+        int first = cluster.cpus.front();
+        LOGI("Topology cluster %zu: %zu core(s) from cpu%d, max %ld kHz, capacity %ld, L1d %zu KB, L2 %zu KB, L3 %zu KB",
+             c, cluster.cpus.size(), first, cluster.max_freq_khz, cluster.capacity,
+             topo.cache_size(1, first) / 1024, topo.cache_size(2, first) / 1024, topo.cache_size(3, first) / 1024);
+    }
+}
+
+const CpuTopology& get_cpu_topology() {
+    static CpuTopology topology;
+    static std::once_flag once;
+    std::call_once(once, [] { discover(topology); });
+    return topology;
+}
+
+int CpuTopology::biggest_core() const {
+    if (clusters.empty()) return 0;
+    const CpuCluster& strongest = clusters.back();
+    int best = strongest.cpus.front();
+    for (int cpu : strongest.cpus) {
+        if (cores[cpu].max_freq_khz > cores[best].max_freq_khz) best = cpu;
+    }
+    return best;
+}
+
+std::vector<int> CpuTopology::performance_cores() const {
+    std::vector<int> result;
+    if (clusters.empty()) return result;
+    // Every cluster as strong as the weakest one is an efficiency cluster
+    const long weakest = cluster_strength(clusters.front());
+    for (const CpuCluster& cluster : clusters) {
+        if (cluster_strength(cluster) > weakest) result.insert(result.end(), cluster.cpus.begin(), cluster.cpus.end());
+    }
+    if (result.empty()) result = online;
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+size_t CpuTopology::cache_size(int level, int cpu) const {
+    if (cpu < 0 || cpu >= static_cast<int>(cores.size())) return 0;
+    for (const CpuCache& cache : cores[cpu].caches) {
+        if (cache.level == level && cache.type != "Instruction") return cache.size_bytes;
+    }
+    return 0;
+}
+
+size_t CpuTopology::cache_line_size(int cpu) const {
+    if (cpu >= 0 && cpu < static_cast<int>(cores.size())) {
+        for (const CpuCache& cache : cores[cpu].caches) {
+            if (cache.line_size > 0) return cache.line_size;
+        }
+    }
+    return 64;
+}
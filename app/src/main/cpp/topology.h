@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// CPU topology discovered once from /sys/devices/system/cpu and cached for the lifetime of the process.
+
+struct CpuCache {
+    int level = 0;
+    std::string type;               // "Data", "Instruction" or "Unified"
+    size_t size_bytes = 0;
+    size_t line_size = 0;
+    std::vector<int> shared_cpus;
+};
+
+struct CpuCore {
+    int id = 0;
+    bool online = false;
+    long max_freq_khz = 0;          // 0 if cpufreq is not exposed
+    long capacity = 0;              // arm64 cpu_capacity (1024 = biggest core), 0 if not exposed
+    int cluster = -1;               // index into CpuTopology::clusters
+    std::vector<int> smt_siblings;  // including the core itself
+    std::vector<CpuCache> caches;
+};
+
+struct CpuCluster {
+    std::vector<int> cpus;          // online CPUs only
+    long max_freq_khz = 0;
+    long capacity = 0;
+};
+
+struct CpuTopology {
+    std::vector<CpuCore> cores;         // every possible CPU, indexed by id
+    std::vector<int> online;
+    std::vector<CpuCluster> clusters;   // ordered from the weakest to the strongest
+
+    int biggest_core() const;
+    // Online cores outside the weakest cluster, or every online core on a homogeneous CPU
+    std::vector<int> performance_cores() const;
+    // Data/unified cache of the given level seen by cpu, 0 if unknown
+    size_t cache_size(int level, int cpu) const;
+    size_t cache_line_size(int cpu) const;
+};
+
+const CpuTopology& get_cpu_topology();
+
+// Parses the kernel cpulist format ("0-3,6,8-9")
+std::vector<int> parse_cpu_list(const std::string& list);
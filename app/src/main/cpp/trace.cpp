@@ -0,0 +1,158 @@
+#include "trace.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t dur_ns;
+    int64_t arg;
+};
+
+struct TraceBuffer {
+    int tid = 0;
+    char thread_name[17] = {};
+    uint32_t generation = 0;
+    std::vector<TraceEvent> events;     // grows up to TRACE_EVENTS_PER_THREAD, then used as a ring
+    std::atomic<uint64_t> count{0};     // events ever recorded in this run
+    std::atomic<bool> exited{false};
+};
+
+// Marks the buffer of an exiting thread, whose events are kept until the next run starts
+struct TraceThreadState {
+    TraceBuffer* buffer = nullptr;
+    ~TraceThreadState() {
+        if (buffer) buffer->exited = true;
+    }
+};
+
+static std::atomic<bool> g_trace_enabled{false};
+static std::atomic<uint32_t> g_trace_generation{0};
+static std::mutex g_trace_mutex;
+static std::vector<std::unique_ptr<TraceBuffer>> g_trace_buffers;
+static std::set<std::string> g_trace_names;
+static thread_local TraceThreadState t_trace_state;
+
+uint64_t trace_now_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static TraceBuffer* thread_buffer() {
+    TraceBuffer* buffer = t_trace_state.buffer;
+    const uint32_t generation = g_trace_generation.load(std::memory_order_acquire);
+    if (buffer && buffer->generation == generation) return buffer;
+
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    if (!buffer) {
+        auto created = std::make_unique<TraceBuffer>();
+        created->tid = static_cast<int>(gettid());
+        prctl(PR_GET_NAME, created->thread_name, 0, 0, 0);
+        buffer = created.get();
+        g_trace_buffers.push_back(std::move(created));
+        t_trace_state.buffer = buffer;
+    }
+    buffer->generation = generation;
+    return buffer;
+}
+
+void trace_begin_run() {
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    // Buffers of threads that have exited are freed; live threads keep theirs, emptied
+    std::vector<std::unique_ptr<TraceBuffer>> live;
+    for (auto& buffer : g_trace_buffers) {
+        if (buffer->exited) continue;
+        buffer->events.clear();
+        buffer->count = 0;
+        live.push_back(std::move(buffer));
+    }
+    g_trace_buffers.swap(live);
+    g_trace_names.clear();
+    g_trace_generation.fetch_add(1, std::memory_order_release);
+    g_trace_enabled = true;
+}
+
+void trace_complete(const char* name, uint64_t start_ns, uint64_t end_ns, int64_t arg) {
+    if (!g_trace_enabled.load(std::memory_order_relaxed)) return;
+    TraceBuffer* buffer = thread_buffer();
+    const uint64_t index = buffer->count.load(std::memory_order_relaxed);
+    TraceEvent event{name, start_ns, end_ns > start_ns ? end_ns - start_ns : 0, arg};
+    if (buffer->events.size() < TRACE_EVENTS_PER_THREAD) {
+        buffer->events.push_back(event);
+    } else {
+        buffer->events[index % TRACE_EVENTS_PER_THREAD] = event;
+    }
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+const char* trace_intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    return g_trace_names.insert(name).first->c_str();
+}
+
+TraceScope::TraceScope(const char* name, int64_t arg) : name_(name), arg_(arg) {
+    if (g_trace_enabled.load(std::memory_order_relaxed)) start_ns_ = trace_now_ns();
+}
+
+void TraceScope::end() {
+    if (start_ns_ == 0) return;
+    trace_complete(name_, start_ns_, trace_now_ns(), arg_);
+    start_ns_ = 0;
+}
+
+static void write_json_string(FILE* f, const char* text) {
+    fputc('"', f);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') fputc('\\', f);
+        if (static_cast<unsigned char>(*c) >= 0x20) fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+bool trace_write(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (!f) {
+        LOGE("Trace: cannot open %s", path.c_str());
+        return false;
+    }
+    const int pid = static_cast<int>(getpid());
+    size_t written = 0;
+
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\",\"args\":{\"name\":\"MaterialBench\"}}", pid);
+    for (const auto& buffer : g_trace_buffers) {
+        const uint64_t count = buffer->count.load(std::memory_order_acquire);
+        if (count == 0) continue;
+        fprintf(f, ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", pid, buffer->tid);
+        write_json_string(f, buffer->thread_name[0] ? buffer->thread_name : "thread");
+        fprintf(f, "}}");
+
+        // Oldest first, so a wrapped ring still comes out in time order
+        const size_t stored = static_cast<size_t>(std::min<uint64_t>(count, buffer->events.size()));
+        const size_t first = count > stored ? static_cast<size_t>(count % stored) : 0;
+        for (size_t i = 0; i < stored; ++i) {
+            const TraceEvent& e = buffer->events[(first + i) % stored];
+            fprintf(f, ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"name\":", pid, buffer->tid);
+            write_json_string(f, e.name);
+            fprintf(f, ",\"ts\":%.3f,\"dur\":%.3f", e.start_ns / 1000.0, e.dur_ns / 1000.0);
+            if (e.arg >= 0) fprintf(f, ",\"args\":{\"i\":%lld}", static_cast<long long>(e.arg));
+            fputc('}', f);
+            ++written;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    bool ok = fclose(f) == 0;
+    LOGI("Trace: %zu events from %zu thread(s) written to %s", written, g_trace_buffers.size(), path.c_str());
+    return ok;
+}
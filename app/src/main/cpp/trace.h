@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Timeline of benchmark phases in the Chrome trace-event format (opens in Perfetto / chrome://tracing).
+// Every thread records complete events (begin + duration) into its own ring buffer without locking;
+// the buffers are written out in one go at the end of a run. Nothing is recorded before the first
+// trace_begin_run(), so a TraceScope outside a run costs one relaxed load.
+
+static const size_t TRACE_EVENTS_PER_THREAD = 16384;    // oldest events are overwritten beyond this
+
+uint64_t trace_now_ns();    // CLOCK_MONOTONIC, the same clock as System.nanoTime()
+
+// Drops the events of the previous run and starts recording; call while no benchmark is running
+void trace_begin_run();
+// Writes every buffered event as {"traceEvents": [...]}; false if the file cannot be written
+bool trace_write(const std::string& path);
+
+// name must outlive the run: a string literal, or trace_intern() for built names
+void trace_complete(const char* name, uint64_t start_ns, uint64_t end_ns, int64_t arg = -1);
+const char* trace_intern(const std::string& name);
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, int64_t arg = -1);
+    ~TraceScope() { end(); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    void end();
+
+private:
+    const char* name_;
+    int64_t arg_;
+    uint64_t start_ns_ = 0;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// Traces the rest of the enclosing block; the optional second argument shows up as args.i
+#define TRACE_SCOPE(...) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(__VA_ARGS__)
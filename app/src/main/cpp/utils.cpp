@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "topology.h"
 #include <thread>
 #include <vector>
 #include <atomic>
@@ -10,6 +11,7 @@
 #include <fstream>
 #include <string>
 #include <vulkan/vulkan.h>
+#include <android/asset_manager_jni.h>
 
 JavaVM* g_vm = nullptr;
 
@@ -19,57 +21,11 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
 }
 
 int get_biggest_core() {
-    int best_core = 0;
-    long best_freq = -1;
-    for (int cpu = 0;; cpu++) {
-        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq";
-        std::ifstream f(path);
-        if (!f.is_open()) break;
-        long freq;
-        f >> freq;
-        if (freq > best_freq) {
-            best_freq = freq;
-            best_core = cpu;
-        }
-    }
-    return best_core;
+    return get_cpu_topology().biggest_core();
 }
 
 std::vector<int> get_performance_cores() {
-    struct Core {
-        int id;
-        long max_freq;
-    };
-
-    std::vector<Core> cores;
-    long min_max_freq = -1;
-
-    for (int cpu = 0;; cpu++) {
-        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq";
-        std::ifstream f(path);
-        if (!f.is_open()) break;
-
-        long freq;
-        f >> freq;
-        cores.push_back({cpu, freq});
-
-        if (min_max_freq == -1 || freq < min_max_freq) {
-            min_max_freq = freq;
-        }
-    }
-
-    std::vector<int> result;
-    for (const auto& core : cores) {
-        if (core.max_freq > min_max_freq) {
-            result.push_back(core.id);
-        }
-    }
-
-    if (result.empty()) {
-        for (const auto& core : cores) result.push_back(core.id);
-    }
-
-    return result;
+    return get_cpu_topology().performance_cores();
 }
 
 void pin_to_core(int core_id) {
@@ -101,6 +57,31 @@ std::string get_files_dir_path(JNIEnv* env, jobject activity) {
     return path;
 }
 
+AAssetManager* get_asset_manager(JNIEnv* env, jobject activity) {
+    jclass activityClass = env->GetObjectClass(activity);
+    jmethodID getAssetsMethod = env->GetMethodID(activityClass, "getAssets", "()Landroid/content/res/AssetManager;");
+    jobject assets = env->CallObjectMethod(activity, getAssetsMethod);
+    return assets ? AAssetManager_fromJava(env, assets) : nullptr;
+}
+
+bool read_asset(AAssetManager* manager, const std::string& path, std::vector<uint8_t>& out) {
+    if (!manager) return false;
+    AAsset* asset = AAssetManager_open(manager, path.c_str(), AASSET_MODE_BUFFER);
+    if (!asset) return false;
+    auto length = static_cast<size_t>(AAsset_getLength(asset));
+    out.resize(length);
+    bool ok = AAsset_read(asset, out.data(), length) == static_cast<int>(length);
+    AAsset_close(asset);
+    return ok;
+}
+
+void prefault_pages(void* data, size_t size) {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto* bytes = static_cast<volatile uint8_t*>(data);
+    for (size_t offset = 0; offset < size; offset += page_size) bytes[offset] = 0;
+    if (size > 0) bytes[size - 1] = 0;
+}
+
 extern "C" {
 
 JNIEXPORT jboolean JNICALL
@@ -1,7 +1,9 @@
 #pragma once
 #include <jni.h>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <android/asset_manager.h>
 
 extern JavaVM* g_vm;
 
@@ -10,6 +12,10 @@ std::vector<int> get_performance_cores();
 void pin_to_core(int core_id);
 void update_progress(JNIEnv* env, jobject activity, jmethodID methodId, float progress);
 std::string get_files_dir_path(JNIEnv* env, jobject activity);
+AAssetManager* get_asset_manager(JNIEnv* env, jobject activity);
+bool read_asset(AAssetManager* manager, const std::string& path, std::vector<uint8_t>& out);
+// Writes one byte per page so first-touch faults are paid before a timed region starts
+void prefault_pages(void* data, size_t size);
 
 #ifndef LOG_UTILS_H
 #define LOG_UTILS_H
@@ -8,9 +8,18 @@
 #include <chrono>
 #include <string>
 #include <algorithm>
+#include <cmath>
 #include <vulkan/vulkan.h>
 #include "gemm_shader_tiled.comp.spv.h"
+#include "empty_dispatch.comp.spv.h"
 #include "utils.h"
+#include "cpu_gemm.h"
+#include "results.h"
+#include "energy.h"
+#include "trace.h"
+#include "sizing.h"
+#include "contention.h"
+#include "histogram.h"
 
 // --- Structures ---
 
@@ -37,6 +46,18 @@ struct GEMMContext {
     uint32_t workgroupCountX = 0, workgroupCountY = 0;
 };
 
+// Empty shader with a push constant and no descriptors, for the dispatch latency benchmark
+struct DispatchContext {
+    SharedVulkanContext* shared = nullptr;
+    VkShaderModule shaderModule{};
+    VkDescriptorSetLayout descriptorSetLayout{};
+    VkPipelineLayout pipelineLayout{};
+    VkPipeline pipeline{};
+    VkCommandPool commandPool{};
+    VkCommandBuffer cmd{};
+    VkFence fence{};
+};
+
 // --- Global State ---
 
 static std::unique_ptr<SharedVulkanContext> g_sharedContext;
@@ -69,6 +90,7 @@ static bool createBuffer(SharedVulkanContext* s, VkDeviceSize size, VkBufferUsag
 }
 
 static bool initShared(SharedVulkanContext &ctx) {
+    TRACE_SCOPE("vk_init_shared");
     VkApplicationInfo ai{VK_STRUCTURE_TYPE_APPLICATION_INFO};
     ai.pApplicationName = "MaterialBench"; ai.apiVersion = VK_API_VERSION_1_1;
     VkInstanceCreateInfo ii{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
@@ -145,6 +167,7 @@ static bool createComputePipeline(VkDevice dev, const uint32_t* code, size_t cod
 }
 
 static bool createGEMMPipeline(GEMMContext &ctx) {
+    TRACE_SCOPE("vk_create_pipeline");
     return createComputePipeline(ctx.shared->device,
                                  reinterpret_cast<const uint32_t*>(gemm_shader_tiled_comp_spv), gemm_shader_tiled_comp_spv_len,
                                  3, sizeof(uint32_t) * 5,
@@ -152,6 +175,7 @@ static bool createGEMMPipeline(GEMMContext &ctx) {
 }
 
 static bool createGEMMBuffersAndDescriptors(GEMMContext &ctx, uint32_t N, uint32_t M, uint32_t K) {
+    TRACE_SCOPE("vk_create_buffers");
     ctx.N = N; ctx.M = M; ctx.K = K;
     VkDeviceSize sizeA = size_t(N) * size_t(K) * sizeof(float);
     VkDeviceSize sizeB = size_t(K) * size_t(M) * sizeof(float);
@@ -194,6 +218,32 @@ static bool createGEMMBuffersAndDescriptors(GEMMContext &ctx, uint32_t N, uint32
     return true;
 }
 
+// Recomputes sampled tiles of C on the CPU (always the first and the last tile, the rest random)
+static bool verifyGEMMTiles(const float* a, const float* b, const float* c, uint32_t N, uint32_t M, uint32_t K) {
+    const uint32_t TILE = 64, TILES = 8;
+    std::vector<int> cores = get_performance_cores();
+    std::vector<float> expected(TILE * TILE);
+    std::default_random_engine rng(static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count()));
+    for (uint32_t t = 0; t < TILES; ++t) {
+        uint32_t rows = std::min(TILE, N), cols = std::min(TILE, M);
+        uint32_t row0 = t == 0 ? 0 : t == 1 ? N - rows : rng() % (N - rows + 1);
+        uint32_t col0 = t == 0 ? 0 : t == 1 ? M - cols : rng() % (M - cols + 1);
+        sgemm(rows, cols, K, a + size_t(row0) * K, K, b + col0, M, expected.data(), TILE, cores);
+        for (uint32_t i = 0; i < rows; ++i) {
+            for (uint32_t j = 0; j < cols; ++j) {
+                float want = expected[i * TILE + j], got = c[size_t(row0 + i) * M + col0 + j];
+                // Inputs are in [0, 1), so |want| bounds the accumulated rounding error of both sides
+                if (!(std::fabs(got - want) <= 1e-3f * std::fabs(want) + 1e-3f)) {
+                    LOGE("GEMM verification failed at C[%u][%u]: GPU %f, CPU %f", row0 + i, col0 + j, got, want);
+                    return false;
+                }
+            }
+        }
+    }
+    LOGI("GEMM verification: %u tiles of %ux%u match the CPU SGEMM", TILES, TILE, TILE);
+    return true;
+}
+
 static jlong runGEMMCompute(GEMMContext &ctx, uint32_t N_param, uint32_t M_param, uint32_t K_param, JNIEnv* env, jobject activity_global_ref, jmethodID update_progress_method_id) {
     const uint32_t CHUNK_WG_X = 32;
     const uint32_t CHUNK_WG_Y = 32;
@@ -204,6 +254,7 @@ static jlong runGEMMCompute(GEMMContext &ctx, uint32_t N_param, uint32_t M_param
     VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
     VkFence fence; if (vkCreateFence(ctx.shared->device, &fci, nullptr, &fence) != VK_SUCCESS) { vkFreeCommandBuffers(ctx.shared->device, ctx.commandPool, 1, &cmd); return -1; }
 
+    EnergyRegion energy;
     auto t0 = std::chrono::high_resolution_clock::now();
     uint32_t totalBatches = 0;
     for (uint32_t by = 0; by < ctx.workgroupCountY; by += CHUNK_WG_Y) for (uint32_t bx = 0; bx < ctx.workgroupCountX; bx += CHUNK_WG_X) ++totalBatches;
@@ -211,6 +262,7 @@ static jlong runGEMMCompute(GEMMContext &ctx, uint32_t N_param, uint32_t M_param
 
     for (uint32_t by = 0; by < ctx.workgroupCountY; by += CHUNK_WG_Y) {
         for (uint32_t bx = 0; bx < ctx.workgroupCountX; bx += CHUNK_WG_X) {
+            TRACE_SCOPE("vk_gemm_chunk", batchIndex);
             uint32_t dispatchX = std::min(CHUNK_WG_X, ctx.workgroupCountX - bx);
             uint32_t dispatchY = std::min(CHUNK_WG_Y, ctx.workgroupCountY - by);
 
@@ -252,19 +304,27 @@ static jlong runGEMMCompute(GEMMContext &ctx, uint32_t N_param, uint32_t M_param
         }
     }
     auto t1 = std::chrono::high_resolution_clock::now();
-    float* cData = nullptr;
+    energy.stop();
+    // A fast but wrong kernel must not post a score: sampled tiles are checked against the CPU SGEMM
+    float *aData = nullptr, *bData = nullptr, *cData = nullptr;
+    VkDeviceSize aSize = size_t(N_param) * size_t(K_param) * sizeof(float);
+    VkDeviceSize bSize = size_t(K_param) * size_t(M_param) * sizeof(float);
     VkDeviceSize cSize = size_t(N_param) * size_t(M_param) * sizeof(float);
-    if (vkMapMemory(ctx.shared->device, ctx.memC, 0, cSize, 0, (void**)&cData) == VK_SUCCESS) {
-        LOGI("=== GEMM (first 5x5) ===");
-        for (uint32_t i = 0; i < std::min<uint32_t>(5, N_param); ++i) {
-            std::string row;
-            for (uint32_t j = 0; j < std::min<uint32_t>(5, M_param); ++j) row += std::to_string(cData[i * M_param + j]) + " ";
-            LOGI("%s", row.c_str());
+    bool verified = false;
+    if (vkMapMemory(ctx.shared->device, ctx.memA, 0, aSize, 0, (void**)&aData) == VK_SUCCESS) {
+        if (vkMapMemory(ctx.shared->device, ctx.memB, 0, bSize, 0, (void**)&bData) == VK_SUCCESS) {
+            if (vkMapMemory(ctx.shared->device, ctx.memC, 0, cSize, 0, (void**)&cData) == VK_SUCCESS) {
+                TRACE_SCOPE("vk_gemm_verify");
+                verified = verifyGEMMTiles(aData, bData, cData, N_param, M_param, K_param);
+                vkUnmapMemory(ctx.shared->device, ctx.memC);
+            }
+            vkUnmapMemory(ctx.shared->device, ctx.memB);
         }
-        vkUnmapMemory(ctx.shared->device, ctx.memC);
+        vkUnmapMemory(ctx.shared->device, ctx.memA);
     }
     vkDestroyFence(ctx.shared->device, fence, nullptr);
     vkFreeCommandBuffers(ctx.shared->device, ctx.commandPool, 1, &cmd);
+    if (!verified) return -1;
     return std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 }
 
@@ -351,6 +411,178 @@ static void gpu_stress_task() {
     g_stressThreadRunning.store(false, std::memory_order_relaxed);
 }
 
+// The stress task's 16x16-workgroup GEMM chunks on a 1024x1024x512 problem, submitted one at a time
+// from a single core; the shared context stays locked for the whole run, like the other GPU tests
+class GpuGemmLoad : public ContentionLoad {
+public:
+    ~GpuGemmLoad() override {
+        std::lock_guard<std::mutex> lock(g_initMutex);
+        if (!ctx_.shared) return;
+        if (fence_) vkDestroyFence(ctx_.shared->device, fence_, nullptr);
+        if (cmd_) vkFreeCommandBuffers(ctx_.shared->device, ctx_.commandPool, 1, &cmd_);
+        cleanupGEMM(ctx_);
+    }
+
+    const char* name() const override { return "gpu_gemm"; }
+    const char* unit() const override { return "gflops"; }
+    int max_cores() const override { return 1; }
+
+    bool prepare() override {
+        std::lock_guard<std::mutex> lock(g_initMutex);
+        SharedVulkanContext* shared = getSharedContext();
+        if (!shared) return false;
+        ctx_.shared = shared;
+        const uint32_t N = 1024, M = 1024, K = 512;
+        ctx_.workgroupCountX = (M + TILE - 1) / TILE;
+        ctx_.workgroupCountY = (N + TILE - 1) / TILE;
+        if (!createGEMMPipeline(ctx_) || !createGEMMBuffersAndDescriptors(ctx_, N, M, K)) return false;
+        VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        allocInfo.commandPool = ctx_.commandPool; allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(shared->device, &allocInfo, &cmd_) != VK_SUCCESS) { cmd_ = VK_NULL_HANDLE; return false; }
+        VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        if (vkCreateFence(shared->device, &fci, nullptr, &fence_) != VK_SUCCESS) { fence_ = VK_NULL_HANDLE; return false; }
+        return true;
+    }
+
+    double run(const std::vector<int>& cores, const std::atomic<bool>& stop) override {
+        pin_to_core(cores[0]);
+        TRACE_SCOPE("contention_gpu_gemm");
+        std::lock_guard<std::mutex> lock(g_initMutex);
+        double flops = 0.0;
+        uint32_t bx = 0, by = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint32_t dx = std::min(CHUNK_WG, ctx_.workgroupCountX - bx);
+            uint32_t dy = std::min(CHUNK_WG, ctx_.workgroupCountY - by);
+            if (!dispatch(bx, by, dx, dy)) break;
+            flops += 2.0 * std::min(dx * TILE, ctx_.M - bx * TILE) * std::min(dy * TILE, ctx_.N - by * TILE) * ctx_.K;
+            bx += CHUNK_WG;
+            if (bx >= ctx_.workgroupCountX) { bx = 0; by += CHUNK_WG; }
+            if (by >= ctx_.workgroupCountY) by = 0;
+        }
+        return flops / 1e9;
+    }
+
+private:
+    static constexpr uint32_t TILE = 16, CHUNK_WG = 16;
+
+    bool dispatch(uint32_t bx, uint32_t by, uint32_t dx, uint32_t dy) {
+        VkDevice device = ctx_.shared->device;
+        vkResetCommandBuffer(cmd_, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+        VkCommandBufferBeginInfo bbi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        bbi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(cmd_, &bbi) != VK_SUCCESS) return false;
+        vkCmdBindPipeline(cmd_, VK_PIPELINE_BIND_POINT_COMPUTE, ctx_.pipeline);
+        vkCmdBindDescriptorSets(cmd_, VK_PIPELINE_BIND_POINT_COMPUTE, ctx_.pipelineLayout, 0, 1, &ctx_.descriptorSet, 0, nullptr);
+        struct PC { uint32_t N, M, K, baseX, baseY; } pc = { ctx_.N, ctx_.M, ctx_.K, bx, by };
+        vkCmdPushConstants(cmd_, ctx_.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pc), &pc);
+        vkCmdDispatch(cmd_, dx, dy, 1);
+        VkMemoryBarrier memBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+        memBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memBarrier, 0, nullptr, 0, nullptr);
+        if (vkEndCommandBuffer(cmd_) != VK_SUCCESS) return false;
+        vkResetFences(device, 1, &fence_);
+        VkSubmitInfo si{VK_STRUCTURE_TYPE_SUBMIT_INFO}; si.commandBufferCount = 1; si.pCommandBuffers = &cmd_;
+        if (vkQueueSubmit(ctx_.shared->computeQueue, 1, &si, fence_) != VK_SUCCESS) return false;
+        if (vkWaitForFences(device, 1, &fence_, VK_TRUE, UINT64_MAX) != VK_SUCCESS) return false;
+        vkQueueWaitIdle(ctx_.shared->computeQueue);
+        return true;
+    }
+
+    GEMMContext ctx_;
+    VkCommandBuffer cmd_ = VK_NULL_HANDLE;
+    VkFence fence_ = VK_NULL_HANDLE;
+};
+
+std::unique_ptr<ContentionLoad> make_gpu_gemm_load() {
+    return std::make_unique<GpuGemmLoad>();
+}
+
+static std::string driverDescription(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    return std::string(props.deviceName) + " driver " + std::to_string(props.driverVersion) +
+           " api " + std::to_string(VK_VERSION_MAJOR(props.apiVersion)) + "." +
+           std::to_string(VK_VERSION_MINOR(props.apiVersion)) + "." + std::to_string(VK_VERSION_PATCH(props.apiVersion));
+}
+
+// --- Dispatch latency ---
+
+static const uint32_t DISPATCH_SAMPLES = 2000;          // per measurement, QUICK runs an eighth
+static const uint32_t DISPATCH_WARMUP = 50;
+static const uint32_t DISPATCH_PUSH_CALLS = 1000;       // vkCmdPushConstants calls per timed recording
+static const uint32_t DISPATCH_BATCHES[] = {1, 10, 100};
+
+static bool createDispatchContext(DispatchContext &ctx) {
+    TRACE_SCOPE("vk_create_dispatch");
+    if (!createComputePipeline(ctx.shared->device,
+                               reinterpret_cast<const uint32_t*>(empty_dispatch_comp_spv), empty_dispatch_comp_spv_len,
+                               0, sizeof(uint32_t),
+                               ctx.shaderModule, ctx.descriptorSetLayout, ctx.pipelineLayout, ctx.pipeline)) return false;
+    VkCommandPoolCreateInfo pci{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    pci.queueFamilyIndex = ctx.shared->computeQueueFamilyIndex;
+    pci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (vkCreateCommandPool(ctx.shared->device, &pci, nullptr, &ctx.commandPool) != VK_SUCCESS) return false;
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.commandPool = ctx.commandPool; allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY; allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(ctx.shared->device, &allocInfo, &ctx.cmd) != VK_SUCCESS) { ctx.cmd = VK_NULL_HANDLE; return false; }
+    VkFenceCreateInfo fci{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    if (vkCreateFence(ctx.shared->device, &fci, nullptr, &ctx.fence) != VK_SUCCESS) { ctx.fence = VK_NULL_HANDLE; return false; }
+    return true;
+}
+
+static void cleanupDispatchContext(DispatchContext &ctx) {
+    if (!ctx.shared || !ctx.shared->device) return;
+    VkDevice d = ctx.shared->device;
+    vkDeviceWaitIdle(d);
+    if (ctx.fence) vkDestroyFence(d, ctx.fence, nullptr);
+    if (ctx.cmd) vkFreeCommandBuffers(d, ctx.commandPool, 1, &ctx.cmd);
+    if (ctx.commandPool) vkDestroyCommandPool(d, ctx.commandPool, nullptr);
+    if (ctx.pipeline) vkDestroyPipeline(d, ctx.pipeline, nullptr);
+    if (ctx.pipelineLayout) vkDestroyPipelineLayout(d, ctx.pipelineLayout, nullptr);
+    if (ctx.descriptorSetLayout) vkDestroyDescriptorSetLayout(d, ctx.descriptorSetLayout, nullptr);
+    if (ctx.shaderModule) vkDestroyShaderModule(d, ctx.shaderModule, nullptr);
+}
+
+// count one-workgroup dispatches, each with its own push constant. A barrier between them makes
+// every dispatch wait for the previous one, like a chain of dependent offloads.
+static bool recordEmptyDispatches(DispatchContext &ctx, uint32_t count) {
+    vkResetCommandBuffer(ctx.cmd, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+    VkCommandBufferBeginInfo bbi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    if (vkBeginCommandBuffer(ctx.cmd, &bbi) != VK_SUCCESS) return false;
+    vkCmdBindPipeline(ctx.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, ctx.pipeline);
+    VkMemoryBarrier memBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    memBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (i > 0) vkCmdPipelineBarrier(ctx.cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memBarrier, 0, nullptr, 0, nullptr);
+        vkCmdPushConstants(ctx.cmd, ctx.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(i), &i);
+        vkCmdDispatch(ctx.cmd, 1, 1, 1);
+    }
+    return vkEndCommandBuffer(ctx.cmd) == VK_SUCCESS;
+}
+
+// Submits the recorded buffer and waits for its fence. submitNs is the CPU time of vkQueueSubmit,
+// roundTripNs the time from the submit call until the fence wait returns.
+static bool submitAndWait(DispatchContext &ctx, uint64_t &submitNs, uint64_t &roundTripNs) {
+    vkResetFences(ctx.shared->device, 1, &ctx.fence);
+    VkSubmitInfo si{VK_STRUCTURE_TYPE_SUBMIT_INFO}; si.commandBufferCount = 1; si.pCommandBuffers = &ctx.cmd;
+    auto t0 = std::chrono::steady_clock::now();
+    if (vkQueueSubmit(ctx.shared->computeQueue, 1, &si, ctx.fence) != VK_SUCCESS) return false;
+    auto t1 = std::chrono::steady_clock::now();
+    if (vkWaitForFences(ctx.shared->device, 1, &ctx.fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) return false;
+    auto t2 = std::chrono::steady_clock::now();
+    submitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    roundTripNs = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t0).count();
+    // Same driver workaround as the GEMM loop, outside the timed part
+    vkQueueWaitIdle(ctx.shared->computeQueue);
+    return true;
+}
+
+static double percentileUs(const LatencyHistogram &h, double p) {
+    return h.percentile(p) / 1000.0;
+}
+
 extern "C" {
 
 JNIEXPORT void JNICALL Java_com_komarudude_materialbench_ui_MainActivity_nativeStopGpuStress(JNIEnv *env, jobject thiz) {
@@ -390,7 +622,17 @@ JNIEXPORT jlong JNICALL Java_com_komarudude_materialbench_ui_BenchActivity_nativ
     if (activity_class) update_progress_method_id = env->GetMethodID(activity_class, "updateBenchmarkProgress", "(F)V");
     GEMMContext ctx;
     ctx.shared = shared;
-    uint32_t N = 8192, M = 8192, K = 5120;
+    const uint32_t FULL_N = 8192, FULL_M = 8192, FULL_K = 5120;
+    uint32_t N = FULL_N, M = FULL_M, K = FULL_K;
+    // Quick profile: half of every dimension, 1/8 of the flops. A, B and C also have to fit in a
+    // quarter of MemAvailable (host-visible buffers share the system RAM on mobile GPUs).
+    if (get_run_profile() == RunProfile::QUICK) { N /= 2; M /= 2; K /= 2; }
+    const size_t mem_limit = read_device_resources().mem_available / 4;
+    while (mem_limit > 0 && N > 1024 &&
+           sizeof(float) * (static_cast<size_t>(N) * K + static_cast<size_t>(K) * M + static_cast<size_t>(N) * M) > mem_limit) {
+        N /= 2; M /= 2;
+    }
+    if (N != FULL_N || K != FULL_K) LOGI("Sizing (%s): GEMM %ux%ux%u", run_profile_name(), N, M, K);
     const uint32_t TILE_DIM = 16;
     ctx.workgroupCountX = (M + TILE_DIM - 1) / TILE_DIM;
     ctx.workgroupCountY = (N + TILE_DIM - 1) / TILE_DIM;
@@ -399,10 +641,130 @@ JNIEXPORT jlong JNICALL Java_com_komarudude_materialbench_ui_BenchActivity_nativ
         env->DeleteGlobalRef(activity_global_ref);
         return -1;
     }
-    jlong duration = runGEMMCompute(ctx, N, M, K, env, activity_global_ref, update_progress_method_id);
+    jlong measured = runGEMMCompute(ctx, N, M, K, env, activity_global_ref, update_progress_method_id);
     cleanupGEMM(ctx);
+    jlong duration = scale_to_full_work(measured, static_cast<double>(N) * M * K, static_cast<double>(FULL_N) * FULL_M * FULL_K);
+    if (duration > 0) {
+        BenchRecord record("gpu_gemm", duration, "ms");
+        record.metric("gflops", measured > 0 ? 2.0 * N * M * K / (measured / 1000.0) / 1e9 : 0.0)
+              .metric("measured_ms", measured)
+              .param("n", N).param("m", M).param("k", K).param("tile", TILE_DIM);
+        record.driver = driverDescription(shared->physicalDevice);
+        record_result(env, activity_global_ref, record);
+    }
     env->DeleteGlobalRef(activity_global_ref);
     return duration;
 }
 
+// Launch overhead of tiny GPU offloads on the shared context, in microseconds: recording one dispatch,
+// the CPU cost of vkQueueSubmit, the submit-to-fence round trip of an empty dispatch, one push-constant
+// update, and the round trip per dispatch when 1, 10 or 100 go into one submit. GPU work below a few
+// round trips cannot pay for its own launch. The result is the median single-dispatch round trip.
+JNIEXPORT jlong JNICALL Java_com_komarudude_materialbench_ui_BenchActivity_nativeRunVulkanDispatchLatencyBenchmark(JNIEnv *env, jobject thiz, jobject activity_param) {
+    std::lock_guard<std::mutex> lock(g_initMutex);
+    SharedVulkanContext* shared = getSharedContext();
+    if (!shared) { LOGE("No shared context"); return -1; }
+    jclass activity_class = env->GetObjectClass(activity_param);
+    jmethodID update_progress_method_id = env->GetMethodID(activity_class, "updateBenchmarkProgress", "(F)V");
+
+    // Submission cost is CPU time, so it is measured from the biggest core
+    const int big_core = get_biggest_core();
+    pin_to_core(big_core);
+
+    DispatchContext ctx;
+    ctx.shared = shared;
+    if (!createDispatchContext(ctx)) { cleanupDispatchContext(ctx); return -1; }
+
+    const auto samples = static_cast<uint32_t>(size_work(DISPATCH_SAMPLES, 100));
+    const size_t batchCount = sizeof(DISPATCH_BATCHES) / sizeof(DISPATCH_BATCHES[0]);
+    const float totalSteps = 2.0f + batchCount;
+    auto elapsedNs = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+    };
+    bool ok = true;
+    uint64_t submitNs = 0, roundTripNs = 0;
+
+    // One dispatch, re-recorded before every submit like a single offload
+    LatencyHistogram recordHist, submitHist, roundTripHist;
+    TraceScope singleTrace("vk_dispatch_single");
+    for (uint32_t i = 0; ok && i < DISPATCH_WARMUP + samples; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        ok = recordEmptyDispatches(ctx, 1);
+        auto t1 = std::chrono::steady_clock::now();
+        ok = ok && submitAndWait(ctx, submitNs, roundTripNs);
+        if (ok && i >= DISPATCH_WARMUP) {
+            recordHist.record(elapsedNs(t0, t1));
+            submitHist.record(submitNs);
+            roundTripHist.record(roundTripNs);
+        }
+    }
+    singleTrace.end();
+    update_progress(env, activity_param, update_progress_method_id, 1.0f / totalSteps);
+
+    // Push constants: only the update calls inside a long recording are timed, the best run counts
+    double pushNs = 0.0;
+    TraceScope pushTrace("vk_dispatch_push");
+    for (uint32_t r = 0; ok && r < std::max(1u, samples / 100); ++r) {
+        vkResetCommandBuffer(ctx.cmd, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+        VkCommandBufferBeginInfo bbi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        if (vkBeginCommandBuffer(ctx.cmd, &bbi) != VK_SUCCESS) { ok = false; break; }
+        vkCmdBindPipeline(ctx.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, ctx.pipeline);
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < DISPATCH_PUSH_CALLS; ++i) {
+            vkCmdPushConstants(ctx.cmd, ctx.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(i), &i);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        ok = vkEndCommandBuffer(ctx.cmd) == VK_SUCCESS;
+        const double perCall = static_cast<double>(elapsedNs(t0, t1)) / DISPATCH_PUSH_CALLS;
+        pushNs = r == 0 ? perCall : std::min(pushNs, perCall);
+    }
+    pushTrace.end();
+    update_progress(env, activity_param, update_progress_method_id, 2.0f / totalSteps);
+
+    // Batches are recorded once and submitted repeatedly, so only submission and execution remain
+    std::vector<double> batchRoundTripUs(batchCount, 0.0);
+    for (size_t b = 0; ok && b < batchCount; ++b) {
+        const uint32_t batch = DISPATCH_BATCHES[b];
+        TRACE_SCOPE("vk_dispatch_batch", batch);
+        ok = recordEmptyDispatches(ctx, batch);
+        LatencyHistogram batchHist;
+        const uint32_t warmup = DISPATCH_WARMUP / batch + 1;
+        const uint32_t submits = std::max<uint32_t>(10, samples / batch);
+        for (uint32_t i = 0; ok && i < warmup + submits; ++i) {
+            ok = submitAndWait(ctx, submitNs, roundTripNs);
+            if (ok && i >= warmup) batchHist.record(roundTripNs);
+        }
+        batchRoundTripUs[b] = percentileUs(batchHist, 50.0);
+        update_progress(env, activity_param, update_progress_method_id, (3.0f + b) / totalSteps);
+    }
+
+    cleanupDispatchContext(ctx);
+    if (!ok) { LOGE("Vulkan dispatch latency: a Vulkan call failed"); return -1; }
+
+    log_latency_histogram("Vulkan record 1 dispatch", recordHist);
+    log_latency_histogram("Vulkan vkQueueSubmit", submitHist);
+    log_latency_histogram("Vulkan dispatch round trip", roundTripHist);
+    LOGI("Vulkan push constant update: %.3f us", pushNs / 1000.0);
+
+    const double roundTripUs = percentileUs(roundTripHist, 50.0);
+    BenchRecord record("gpu_dispatch_latency", std::max<jlong>(1, std::llround(roundTripUs)), "us");
+    record.on_core(big_core)
+          .metric("record_p50_us", percentileUs(recordHist, 50.0)).metric("record_p99_us", percentileUs(recordHist, 99.0))
+          .metric("submit_p50_us", percentileUs(submitHist, 50.0)).metric("submit_p99_us", percentileUs(submitHist, 99.0))
+          .metric("round_trip_p50_us", roundTripUs).metric("round_trip_p99_us", percentileUs(roundTripHist, 99.0))
+          .metric("round_trip_min_us", roundTripHist.min_ns / 1000.0)
+          .metric("push_constant_us", pushNs / 1000.0)
+          .param("samples", samples).param("push_calls", DISPATCH_PUSH_CALLS);
+    for (size_t b = 0; b < batchCount; ++b) {
+        const std::string prefix = "batch" + std::to_string(DISPATCH_BATCHES[b]);
+        record.metric(prefix + "_round_trip_us", batchRoundTripUs[b])
+              .metric(prefix + "_per_dispatch_us", batchRoundTripUs[b] / DISPATCH_BATCHES[b]);
+        LOGI("Vulkan %3u dispatches per submit: %.1f us round trip, %.2f us per dispatch", DISPATCH_BATCHES[b],
+             batchRoundTripUs[b], batchRoundTripUs[b] / DISPATCH_BATCHES[b]);
+    }
+    record.driver = driverDescription(shared->physicalDevice);
+    record_result(env, activity_param, record);
+    return record.result;
+}
+
 }
\ No newline at end of file
@@ -28,24 +28,42 @@ import androidx.compose.ui.res.stringResource
 import androidx.compose.ui.text.font.FontWeight
 import androidx.compose.ui.tooling.preview.Preview
 import androidx.compose.ui.unit.dp
+import com.google.ai.edge.litert.Accelerator
 import com.komarudude.materialbench.BenchScores
 import com.komarudude.materialbench.R
 import com.komarudude.materialbench.ui.theme.MaterialBenchTheme
 import com.komarudude.materialbench.utils.MobileNetV4Classifier
 import com.komarudude.materialbench.utils.RetrofitClient
 import com.komarudude.materialbench.utils.ScoreRequest
-import com.komarudude.materialbench.utils.loadAndPrepareImage
 import com.komarudude.materialbench.utils.IntegrityChecker
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
 import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.withContext
 
 private const val LITE_RT_SCORE_SCALE = 1_000_000_0
+// Throughput score = best images per second across the accelerator sweep * scale
+private const val LITE_RT_THROUGHPUT_SCORE_SCALE = 100
+private const val LITE_RT_THROUGHPUT_IMAGES = 16
+private const val LITE_RT_THROUGHPUT_WARMUP_RUNS = 2
+private const val LITE_RT_THROUGHPUT_DURATION_NS = 5_000_000_000L
+private val LITE_RT_THROUGHPUT_ACCELERATORS = listOf(Accelerator.CPU, Accelerator.GPU, Accelerator.NPU)
+private val LITE_RT_THROUGHPUT_INSTANCES = listOf(1, 2)
+// Quick run profile (CI smoke runs): fewer images and a shorter throughput window per configuration
+private const val LITE_RT_QUICK_IMAGES = 12
+private const val LITE_RT_THROUGHPUT_QUICK_DURATION_NS = 1_000_000_000L
+// Upper bound for the crypto tests: shared input plus per-thread chunk buffers
+private const val CRYPTO_MEMORY_BUDGET_MB = 64
 
 class BenchActivity : ComponentActivity() {
     var onProgressUpdate: ((Float) -> Unit)? = null
     lateinit var classifier: MobileNetV4Classifier
+    // Set from the run_profile intent extra, e.g. adb shell am start -n ... --es run_profile quick
+    var quickProfile = false
+        private set
     @Keep
     fun updateBenchmarkProgress(progress: Float) {
         onProgressUpdate?.invoke(progress)
@@ -54,18 +72,59 @@ class BenchActivity : ComponentActivity() {
 
     external fun nativeRunCpuMathSingleCoreBenchmark(activity: BenchActivity): Long
     external fun nativeRunCpuMathMultiCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuSgemmBenchmark(activity: BenchActivity): Long
     external fun nativeRunRamSequentialWriteBenchmark(activity: BenchActivity): Long
     external fun nativeRunRamSequentialReadBenchmark(activity: BenchActivity): Long
+    external fun nativeRunRamBandwidthSweepBenchmark(activity: BenchActivity): Long
+    external fun nativeRunRamPageFaultBenchmark(activity: BenchActivity): Long
+    external fun nativeRunRamAllocSingleThreadBenchmark(activity: BenchActivity): Long
+    external fun nativeRunRamAllocMultiThreadBenchmark(activity: BenchActivity): Long
     external fun nativeRunRomMixedRandomBenchmark(activity: BenchActivity): Long
+    external fun nativeGetRomRandomTailLatencyUs(): Long
     external fun nativeRunRomSequentialWriteBenchmark(activity: BenchActivity): Long
     external fun nativeRunRomSequentialReadBenchmark(activity: BenchActivity): Long
-    external fun nativeRunCpuCryptoSingleCoreBenchmark(activity: BenchActivity): Long
-    external fun nativeRunCpuCryptoMultiCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunRomWalSyncBenchmark(activity: BenchActivity): Long
+    external fun nativeRunMixedContentionBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuCryptoSingleCoreBenchmark(activity: BenchActivity, memoryBudgetMb: Int): Long
+    external fun nativeRunCpuCryptoMultiCoreBenchmark(activity: BenchActivity, memoryBudgetMb: Int): Long
+    external fun nativeRunCpuCryptoParallelCtrBenchmark(activity: BenchActivity, memoryBudgetMb: Int): Long
+    external fun nativeRunCpuCryptoSweepBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuPubkeySingleCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuPubkeyMultiCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuCompressSingleCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuCompressMultiCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuIntegerSingleCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuIntegerMultiCoreBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuCoreToCoreLatencyBenchmark(activity: BenchActivity): Long
+    external fun nativeRunCpuSyncContentionBenchmark(activity: BenchActivity): Long
     external fun nativeRunVulkanGEMMBenchmark(activity: BenchActivity): Long
+    external fun nativeRunVulkanDispatchLatencyBenchmark(activity: BenchActivity): Long
+    external fun nativeAiDecodeImages(activity: BenchActivity, paths: Array<String>): Long
+    external fun nativeAiNormalizeImage(index: Int, output: FloatArray): Long
+    external fun nativeAiReleaseImages()
+    external fun nativeSetRunProfile(profile: Int)
+    external fun nativeBeginResultRun()
+    external fun nativeFinishResultRun(activity: BenchActivity)
+    external fun nativeBeginTestAccounting()
+    external fun nativeRunPreflight(): Double
+    external fun nativeTraceEvent(name: String, startNs: Long, endNs: Long)
+    external fun nativeRecordResult(
+        activity: BenchActivity,
+        test: String,
+        result: Long,
+        unit: String,
+        metricNames: Array<String>,
+        metricValues: DoubleArray
+    )
     external fun hasVulkanRt(): Boolean
     external fun nativeBenchCleanup()
 
     companion object {
+        const val EXTRA_RUN_PROFILE = "run_profile"
+        // Must match RunProfile in sizing.h
+        const val RUN_PROFILE_QUICK = 0
+        const val RUN_PROFILE_FULL = 1
+
         init {
             try {
                 System.loadLibrary("materialbench")
@@ -78,6 +137,7 @@ class BenchActivity : ComponentActivity() {
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
         val appContext = applicationContext
+        quickProfile = intent.getStringExtra(EXTRA_RUN_PROFILE) == "quick"
         classifier = MobileNetV4Classifier(
             appContext,
             "mobilenetv4_conv_large.e600_r384_in1k_float16.tflite"
@@ -141,37 +201,75 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
     val backToMenuString = stringResource(R.string.back_to_menu)
     val cpuMathSingleString = stringResource(R.string.cpu_math_single)
     val cpuMathMultiString = stringResource(R.string.cpu_math_multi)
+    val cpuSgemm = stringResource(R.string.cpu_sgemm)
     val ramSeqWrite = stringResource(R.string.ram_seq_write)
     val ramSeqRead = stringResource(R.string.ram_seq_read)
+    val ramBandwidthSweep = stringResource(R.string.ram_bandwidth_sweep)
+    val ramPageFault = stringResource(R.string.ram_page_fault)
+    val ramAllocSingle = stringResource(R.string.ram_alloc_single)
+    val ramAllocMulti = stringResource(R.string.ram_alloc_multi)
     val romRandOps = stringResource(R.string.rom_rand_ops)
     val romSeqWrite = stringResource(R.string.rom_seq_write)
     val romSeqRead = stringResource(R.string.rom_seq_read)
+    val romWalSync = stringResource(R.string.rom_wal_sync)
+    val mixedContention = stringResource(R.string.mixed_contention)
     val cpuCryptoSingle = stringResource(R.string.cpu_crypto_single)
     val cpuCryptoMulti = stringResource(R.string.cpu_crypto_multi)
+    val cpuCryptoParallelCtr = stringResource(R.string.cpu_crypto_parallel_ctr)
+    val cpuCryptoSweep = stringResource(R.string.cpu_crypto_sweep)
+    val cpuPubkeySingle = stringResource(R.string.cpu_pubkey_single)
+    val cpuPubkeyMulti = stringResource(R.string.cpu_pubkey_multi)
+    val cpuCompressSingle = stringResource(R.string.cpu_compress_single)
+    val cpuCompressMulti = stringResource(R.string.cpu_compress_multi)
+    val cpuIntegerSingle = stringResource(R.string.cpu_integer_single)
+    val cpuIntegerMulti = stringResource(R.string.cpu_integer_multi)
+    val cpuC2cLatency = stringResource(R.string.cpu_c2c_latency)
+    val cpuSyncContention = stringResource(R.string.cpu_sync_contention)
     val gpuVulkanComputeGemm = stringResource(R.string.vulkan_compute_gemm)
+    val gpuDispatchLatency = stringResource(R.string.gpu_dispatch_latency)
     val gpuRT = stringResource(R.string.gpu_rt)
     val aiLiteRT = stringResource(R.string.ai_litert)
+    val aiLiteRTThroughput = stringResource(R.string.ai_litert_throughput)
     val testSteps = remember {
         listOf(
             // CPU
             TestStep("cpu_math_single", cpuMathSingleString, TestCategory.CPU),
             TestStep("cpu_math_multi", cpuMathMultiString, TestCategory.CPU),
+            TestStep("cpu_sgemm", cpuSgemm, TestCategory.CPU),
             TestStep("cpu_crypto_single", cpuCryptoSingle, TestCategory.CPU),
             TestStep("cpu_crypto_multi", cpuCryptoMulti, TestCategory.CPU),
+            TestStep("cpu_crypto_parallel_ctr", cpuCryptoParallelCtr, TestCategory.CPU),
+            TestStep("cpu_crypto_sweep", cpuCryptoSweep, TestCategory.CPU),
+            TestStep("cpu_pubkey_single", cpuPubkeySingle, TestCategory.CPU),
+            TestStep("cpu_pubkey_multi", cpuPubkeyMulti, TestCategory.CPU),
+            TestStep("cpu_compress_single", cpuCompressSingle, TestCategory.CPU),
+            TestStep("cpu_compress_multi", cpuCompressMulti, TestCategory.CPU),
+            TestStep("cpu_integer_single", cpuIntegerSingle, TestCategory.CPU),
+            TestStep("cpu_integer_multi", cpuIntegerMulti, TestCategory.CPU),
+            TestStep("cpu_c2c_latency", cpuC2cLatency, TestCategory.CPU),
+            TestStep("cpu_sync_contention", cpuSyncContention, TestCategory.CPU),
 
             // GPU
             TestStep("gpu_gemm", gpuVulkanComputeGemm, TestCategory.GPU),
+            TestStep("gpu_dispatch_latency", gpuDispatchLatency, TestCategory.GPU),
             TestStep("gpu_rt", gpuRT, TestCategory.GPU),
 
             // MEM
             TestStep("ram_seq_write", ramSeqWrite, TestCategory.MEM),
             TestStep("ram_seq_read", ramSeqRead, TestCategory.MEM),
+            TestStep("ram_bandwidth_sweep", ramBandwidthSweep, TestCategory.MEM),
+            TestStep("ram_page_fault", ramPageFault, TestCategory.MEM),
+            TestStep("ram_alloc_single", ramAllocSingle, TestCategory.MEM),
+            TestStep("ram_alloc_multi", ramAllocMulti, TestCategory.MEM),
             TestStep("rom_rand_ops", romRandOps, TestCategory.MEM),
             TestStep("rom_seq_write", romSeqWrite, TestCategory.MEM),
             TestStep("rom_seq_read", romSeqRead, TestCategory.MEM),
+            TestStep("rom_wal_sync", romWalSync, TestCategory.MEM),
+            TestStep("mixed_contention", mixedContention, TestCategory.MEM),
 
             // AI
-            TestStep("ai_litert", aiLiteRT, TestCategory.AI)
+            TestStep("ai_litert", aiLiteRT, TestCategory.AI),
+            TestStep("ai_litert_throughput", aiLiteRTThroughput, TestCategory.AI)
         )
     }
 
@@ -231,11 +329,19 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
             Log.w("MaterialBench", context.getString(R.string.device_incomplete_feature))
         }
 
+        // Every native result record of this run is tagged with the same run id and profile
+        activity.nativeSetRunProfile(if (activity.quickProfile) BenchActivity.RUN_PROFILE_QUICK else BenchActivity.RUN_PROFILE_FULL)
+        activity.nativeBeginResultRun()
+
         delay(600)
         for (i in testSteps.indices) {
             currentStepIndex = i
             val step = testSteps[i]
             currentStepProgress = 0f // Reset step progress before starting new
+            // Waits for leftover heat and background load to settle; not part of the step's time
+            withContext(Dispatchers.Default) { activity.nativeRunPreflight() }
+            val stepStartNs = System.nanoTime()
+            activity.nativeBeginTestAccounting()
 
             var generatedScore: Int
 
@@ -253,18 +359,88 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                             scale = 100_000_000
                         )
                     }
+                    "cpu_sgemm" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuSgemmBenchmark(activity) },
+                            scale = 100_000_000
+                        )
+                    }
                     "cpu_crypto_single" -> {
                         runNativeBenchmark(
-                            call = { activity.nativeRunCpuCryptoSingleCoreBenchmark(activity) },
+                            call = { activity.nativeRunCpuCryptoSingleCoreBenchmark(activity, CRYPTO_MEMORY_BUDGET_MB) },
                             scale = 100_000_000
                         )
                     }
                     "cpu_crypto_multi" -> {
                         runNativeBenchmark(
-                            call = { activity.nativeRunCpuCryptoMultiCoreBenchmark(activity) },
+                            call = { activity.nativeRunCpuCryptoMultiCoreBenchmark(activity, CRYPTO_MEMORY_BUDGET_MB) },
+                            scale = 100_000_000
+                        )
+                    }
+                    "cpu_crypto_parallel_ctr" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuCryptoParallelCtrBenchmark(activity, CRYPTO_MEMORY_BUDGET_MB) },
                             scale = 100_000_000
                         )
                     }
+                    "cpu_crypto_sweep" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuCryptoSweepBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_pubkey_single" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuPubkeySingleCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_pubkey_multi" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuPubkeyMultiCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_compress_single" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuCompressSingleCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_compress_multi" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuCompressMultiCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_integer_single" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuIntegerSingleCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_integer_multi" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuIntegerMultiCoreBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "cpu_c2c_latency" -> {
+                        // Returns the mean round trip in nanoseconds, lower is better;
+                        // 100-200 ns scores 10k-20k, the range of the millisecond CPU steps
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuCoreToCoreLatencyBenchmark(activity) },
+                            scale = 2_000_000
+                        )
+                    }
+                    "cpu_sync_contention" -> {
+                        // Returns the geometric mean ns per operation at full thread count, lower is better;
+                        // 20-100 ns scores 10k-50k, the range of the millisecond CPU steps
+                        runNativeBenchmark(
+                            call = { activity.nativeRunCpuSyncContentionBenchmark(activity) },
+                            scale = 1_000_000
+                        )
+                    }
                     "ram_seq_write" -> {
                         runNativeBenchmark(
                             call = { activity.nativeRunRamSequentialWriteBenchmark(activity) },
@@ -277,11 +453,45 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                             scale = 10_000_000
                         )
                     }
-                    "rom_rand_ops" -> {
+                    "ram_bandwidth_sweep" -> {
                         runNativeBenchmark(
+                            call = { activity.nativeRunRamBandwidthSweepBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "ram_page_fault" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunRamPageFaultBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "ram_alloc_single" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunRamAllocSingleThreadBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "ram_alloc_multi" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunRamAllocMultiThreadBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "rom_rand_ops" -> {
+                        // Total time plus the p99.9 tail latency of the same run's per-I/O histograms
+                        val opsScore = runNativeBenchmark(
                             call = { activity.nativeRunRomMixedRandomBenchmark(activity) },
                             scale = 10_000_000
                         )
+                        val tailScore = if (opsScore > 0) {
+                            runNativeBenchmark(
+                                call = { activity.nativeGetRomRandomTailLatencyUs() },
+                                scale = 100_000_000
+                            )
+                        } else {
+                            0
+                        }
+                        (opsScore.toLong() + tailScore).coerceAtMost(Int.MAX_VALUE.toLong()).toInt()
                     }
                     "rom_seq_write" -> {
                         runNativeBenchmark(
@@ -295,6 +505,18 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                             scale = 10_000_000
                         )
                     }
+                    "rom_wal_sync" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunRomWalSyncBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
+                    "mixed_contention" -> {
+                        runNativeBenchmark(
+                            call = { activity.nativeRunMixedContentionBenchmark(activity) },
+                            scale = 10_000_000
+                        )
+                    }
                     "gpu_gemm" -> {
                         if (hasVulkanCompute) {
                             runNativeBenchmark(
@@ -305,6 +527,18 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                             0
                         }
                     }
+                    "gpu_dispatch_latency" -> {
+                        // Returns the median empty-dispatch round trip in microseconds, lower is better;
+                        // about 100 us scores 30k, in line with gpu_gemm
+                        if (hasVulkanCompute) {
+                            runNativeBenchmark(
+                                call = { activity.nativeRunVulkanDispatchLatencyBenchmark(activity) },
+                                scale = 3_000_000
+                            )
+                        } else {
+                            0
+                        }
+                    }
                     "gpu_rt" -> {
                         if (isSupportVulkanRT) {
                             if (!IntegrityChecker.isCompanionTrustworthy(context)) {
@@ -329,6 +563,9 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                     "ai_litert" -> {
                         runLiteRtBenchmark(activity)
                     }
+                    "ai_litert_throughput" -> {
+                        runLiteRtThroughputBenchmark(activity)
+                    }
                     else -> {
                         val simulatedStepDuration = 1000L
                         val score = 0
@@ -346,13 +583,18 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
                 generatedScore = 1
             }
 
+            activity.nativeTraceEvent(step.id, stepStartNs, System.nanoTime())
             stepScores[step.id] = generatedScore
-            withContext(Dispatchers.IO) {
-                BenchScores.saveScore(activity, step.id, generatedScore)
+            // Quick-profile scores are extrapolated from 1/8 of the work, so they never replace saved ones
+            if (!activity.quickProfile) {
+                withContext(Dispatchers.IO) {
+                    BenchScores.saveScore(activity, step.id, generatedScore)
+                }
             }
             currentStepProgress = 1f // Noting step as completed
         }
 
+        withContext(Dispatchers.IO) { activity.nativeFinishResultRun(activity) }
         currentStepIndex = -2
         finished = true
 
@@ -362,22 +604,26 @@ fun BenchScreen(modifier: Modifier = Modifier, onBackToMenu: () -> Unit, activit
         val aiScore = categoryScores[TestCategory.AI] ?: 0
         val overallScore = cpuScore + gpuScore + memScore + aiScore
 
-        withContext(Dispatchers.IO) {
-            BenchScores.saveScore(activity, "CPU Benchmark", cpuScore)
-            BenchScores.saveScore(activity, "GPU Benchmark", gpuScore)
-            BenchScores.saveScore(activity, "Memory Test", memScore)
-            BenchScores.saveScore(activity, "AI Test", aiScore)
-            BenchScores.saveScore(activity, "overall_score", overallScore)
-        }
+        if (activity.quickProfile) {
+            Log.i("BenchScreen", "Quick profile: overall $overallScore is neither saved nor submitted")
+        } else {
+            withContext(Dispatchers.IO) {
+                BenchScores.saveScore(activity, "CPU Benchmark", cpuScore)
+                BenchScores.saveScore(activity, "GPU Benchmark", gpuScore)
+                BenchScores.saveScore(activity, "Memory Test", memScore)
+                BenchScores.saveScore(activity, "AI Test", aiScore)
+                BenchScores.saveScore(activity, "overall_score", overallScore)
+            }
 
-        val service = RetrofitClient.apiService
-        val versionCode = activity.packageManager.getPackageInfo(activity.packageName, 0).longVersionCode
+            val service = RetrofitClient.apiService
+            val versionCode = activity.packageManager.getPackageInfo(activity.packageName, 0).longVersionCode
 
-        try {
-            val response = service.submit(ScoreRequest(overallScore, versionCode))
-            Log.d("BenchScreen", "Score submitted successfully: ${response.message}")
-        } catch (e: Exception) {
-            Log.e("BenchScreen", "Error submitting score: ${e.message}")
+            try {
+                val response = service.submit(ScoreRequest(overallScore, versionCode))
+                Log.d("BenchScreen", "Score submitted successfully: ${response.message}")
+            } catch (e: Exception) {
+                Log.e("BenchScreen", "Error submitting score: ${e.message}")
+            }
         }
 
         activity.onProgressUpdate = null
@@ -583,37 +829,38 @@ private suspend fun runNativeBenchmark(
 private suspend fun runLiteRtBenchmark(activity: BenchActivity): Int {
     activity.classifier.initialize()
 
-    val imagesCount = 100
+    val imagesCount = if (activity.quickProfile) LITE_RT_QUICK_IMAGES else 100
     val allTestPaths = (1..imagesCount)
         .map { "images/$it.jpg" }
         .toMutableList()
     val totalRuns = allTestPaths.size
 
-    val rawImageMap: Map<String, ByteArray?> = withContext(Dispatchers.IO) {
-        allTestPaths.associateWith { path -> loadAndPrepareImage(activity, path) }
+    // Preprocessing runs natively and is timed apart from inference:
+    // parallel JPEG decode once, then a SIMD normalize into one reused input array per image
+    val decodeTimeMs = withContext(Dispatchers.Default) {
+        activity.nativeAiDecodeImages(activity, allTestPaths.toTypedArray())
     }
-
-    val imageMap: Map<String, ByteArray> = rawImageMap.mapNotNull { (k, v) ->
-        v?.let { k to it }
-    }.toMap()
-
-    if (imageMap.size != allTestPaths.size) {
-        val missing = allTestPaths.filter { !imageMap.containsKey(it) }
-        Log.e("MaterialBench", "Error: Failed to load ${missing.size} images: $missing")
+    if (decodeTimeMs < 0) {
+        Log.e("MaterialBench", "Error: Failed to decode the LiteRT images")
+        activity.nativeAiReleaseImages()
         activity.classifier.close()
         return 0
     }
 
+    val inputFloat = FloatArray(activity.classifier.INPUT_SIZE)
     var totalTimeNs = 0L
+    var normalizeTimeNs = 0L
     val uncertThreshold = 0.30f
 
     try {
         for ((index, path) in allTestPaths.withIndex()) {
-            val imagePixels = imageMap[path]!!
+            val normalizeNs = activity.nativeAiNormalizeImage(index, inputFloat)
+            if (normalizeNs < 0) throw IllegalStateException("Failed to normalize $path")
+            normalizeTimeNs += normalizeNs
 
             val startTime = System.nanoTime()
             val result = withContext(Dispatchers.Default) {
-                activity.classifier.runInference(imagePixels, topKCount = 5)
+                activity.classifier.runInference(inputFloat, topKCount = 5)
             }
             val timeNs = System.nanoTime() - startTime
             totalTimeNs += timeNs
@@ -639,13 +886,141 @@ private suspend fun runLiteRtBenchmark(activity: BenchActivity): Int {
         e.printStackTrace()
         return 0
     } finally {
+        activity.nativeAiReleaseImages()
         activity.classifier.close()
     }
 
     val averageTimeMs = if (totalRuns > 0) totalTimeNs.toDouble() / totalRuns.toDouble() / 1_000_000.0 else 0.0
     val score = if (averageTimeMs <= 0.0) 0 else (LITE_RT_SCORE_SCALE / averageTimeMs).toInt()
 
+    val averageNormalizeUs = if (totalRuns > 0) normalizeTimeNs.toDouble() / totalRuns.toDouble() / 1_000.0 else 0.0
+    Log.i(
+        "MaterialBench",
+        "LiteRT preprocessing — decode = $decodeTimeMs ms for $totalRuns images, " +
+                "normalize avg = ${"%.1f".format(averageNormalizeUs)} us per image (not part of the score)"
+    )
+
     Log.i("MaterialBench", "LiteRT benchmark finished — avg time = ${"%.3f".format(averageTimeMs)} ms, score = $score")
+    activity.nativeRecordResult(
+        activity, "ai_litert", totalTimeNs / 1_000_000, "ms",
+        arrayOf("avg_inference_ms", "decode_ms", "avg_normalize_us", "images"),
+        doubleArrayOf(averageTimeMs, decodeTimeMs.toDouble(), averageNormalizeUs, totalRuns.toDouble())
+    )
+    return score
+}
+
+private fun latencyPercentileMs(sortedNs: LongArray, percentile: Double): Double {
+    if (sortedNs.isEmpty()) return 0.0
+    val rank = kotlin.math.ceil(percentile / 100.0 * sortedNs.size).toInt().coerceIn(1, sortedNs.size)
+    return sortedNs[rank - 1] / 1_000_000.0
+}
+
+/**
+ * Throughput mode: every accelerator in the sweep runs K independent model instances at once,
+ * each on its own thread with tensor buffers allocated once, over inputs normalized ahead of time.
+ * Accelerators that fail to compile the model (e.g. no NPU delegate) are skipped.
+ * Returns the score of the best configuration in images per second.
+ */
+private suspend fun runLiteRtThroughputBenchmark(activity: BenchActivity): Int {
+    val paths = (1..LITE_RT_THROUGHPUT_IMAGES).map { "images/$it.jpg" }
+    val decodeTimeMs = withContext(Dispatchers.Default) {
+        activity.nativeAiDecodeImages(activity, paths.toTypedArray())
+    }
+    if (decodeTimeMs < 0) {
+        Log.e("MaterialBench", "Error: Failed to decode the LiteRT images")
+        activity.nativeAiReleaseImages()
+        return 0
+    }
+
+    val inputs = try {
+        paths.indices.map { index ->
+            FloatArray(activity.classifier.INPUT_SIZE).also {
+                if (activity.nativeAiNormalizeImage(index, it) < 0) {
+                    throw IllegalStateException("Failed to normalize ${paths[index]}")
+                }
+            }
+        }
+    } catch (e: Exception) {
+        Log.e("MaterialBench", "LiteRT throughput: ${e.message}")
+        return 0
+    } finally {
+        activity.nativeAiReleaseImages()
+    }
+
+    val durationNs = if (activity.quickProfile) LITE_RT_THROUGHPUT_QUICK_DURATION_NS else LITE_RT_THROUGHPUT_DURATION_NS
+    val totalConfigs = LITE_RT_THROUGHPUT_ACCELERATORS.size * LITE_RT_THROUGHPUT_INSTANCES.size
+    var configIndex = 0
+    var bestImagesPerSecond = 0.0
+    val metricNames = ArrayList<String>()
+    val metricValues = ArrayList<Double>()
+
+    for (accelerator in LITE_RT_THROUGHPUT_ACCELERATORS) {
+        for (instanceCount in LITE_RT_THROUGHPUT_INSTANCES) {
+            val classifiers = List(instanceCount) { MobileNetV4Classifier(activity, accelerator = accelerator) }
+            try {
+                withContext(Dispatchers.Default) { classifiers.forEach { it.initialize() } }
+                if (classifiers.any { !it.isInitialized }) {
+                    Log.w("MaterialBench", "LiteRT throughput: $accelerator x$instanceCount unavailable, skipped")
+                    continue
+                }
+
+                // Warm-up (and first-run GPU/NPU compilation) of every instance finishes before the window opens
+                coroutineScope {
+                    classifiers.map { classifier ->
+                        async(Dispatchers.Default) {
+                            repeat(LITE_RT_THROUGHPUT_WARMUP_RUNS) { classifier.runInferenceInPlace(inputs[it % inputs.size]) }
+                        }
+                    }.awaitAll()
+                }
+
+                val startTime = System.nanoTime()
+                val latencies = coroutineScope {
+                    classifiers.mapIndexed { instance, classifier ->
+                        async(Dispatchers.Default) {
+                            val runLatencies = ArrayList<Long>()
+                            var next = instance
+                            while (System.nanoTime() - startTime < durationNs) {
+                                val runStart = System.nanoTime()
+                                classifier.runInferenceInPlace(inputs[next % inputs.size])
+                                runLatencies.add(System.nanoTime() - runStart)
+                                next += instanceCount
+                            }
+                            runLatencies
+                        }
+                    }.awaitAll()
+                }
+                val elapsedNs = System.nanoTime() - startTime
+                Log.d("MaterialBench", "LiteRT throughput $accelerator x$instanceCount: last top-1 = ${classifiers[0].lastTop1()}")
+
+                val sorted = latencies.flatten().toLongArray().also { it.sort() }
+                val imagesPerSecond = sorted.size * 1_000_000_000.0 / elapsedNs
+                if (imagesPerSecond > bestImagesPerSecond) bestImagesPerSecond = imagesPerSecond
+                val config = "${accelerator.name.lowercase()}_x$instanceCount"
+                metricNames += listOf("${config}_images_per_s", "${config}_p50_ms", "${config}_p99_ms")
+                metricValues += listOf(imagesPerSecond, latencyPercentileMs(sorted, 50.0), latencyPercentileMs(sorted, 99.0))
+                Log.i(
+                    "MaterialBench",
+                    "LiteRT throughput $accelerator x$instanceCount: ${sorted.size} images, " +
+                            "${"%.2f".format(imagesPerSecond)} images/s, " +
+                            "p50 = ${"%.2f".format(latencyPercentileMs(sorted, 50.0))} ms, " +
+                            "p90 = ${"%.2f".format(latencyPercentileMs(sorted, 90.0))} ms, " +
+                            "p99 = ${"%.2f".format(latencyPercentileMs(sorted, 99.0))} ms"
+                )
+            } catch (e: Exception) {
+                Log.e("MaterialBench", "LiteRT throughput $accelerator x$instanceCount failed: ${e.message}")
+            } finally {
+                classifiers.forEach { it.close() }
+                activity.onProgressUpdate?.invoke((++configIndex).toFloat() / totalConfigs.toFloat())
+            }
+        }
+    }
+
+    val score = (bestImagesPerSecond * LITE_RT_THROUGHPUT_SCORE_SCALE).toInt()
+    Log.i("MaterialBench", "LiteRT throughput finished — best = ${"%.2f".format(bestImagesPerSecond)} images/s, score = $score")
+    activity.nativeRecordResult(
+        activity, "ai_litert_throughput", (bestImagesPerSecond + 0.5).toLong(), "images_per_s",
+        metricNames.toTypedArray(), metricValues.toDoubleArray()
+    )
     return score
 }
 
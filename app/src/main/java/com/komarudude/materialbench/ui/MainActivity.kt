@@ -580,6 +580,7 @@ fun BenchMainScreen() {
     val cpuIconText = stringResource(id = R.string.cpu_icon_text)
     val cpuMathSingleString = stringResource(R.string.cpu_math_single)
     val cpuMathMultiString = stringResource(R.string.cpu_math_multi)
+    val cpuSgemm = stringResource(R.string.cpu_sgemm)
     val gpuBenchmarkTitle = stringResource(id = R.string.gpu_benchmark_title)
     val gpuBenchmarkDescription = stringResource(id = R.string.gpu_benchmark_description)
     val gpuIconText = stringResource(id = R.string.gpu_icon_text)
@@ -591,14 +592,32 @@ fun BenchMainScreen() {
     val aiIconText = stringResource(id = R.string.ai_icon_text)
     val ramSeqWrite = stringResource(R.string.ram_seq_write)
     val ramSeqRead = stringResource(R.string.ram_seq_read)
+    val ramBandwidthSweep = stringResource(R.string.ram_bandwidth_sweep)
+    val ramPageFault = stringResource(R.string.ram_page_fault)
+    val ramAllocSingle = stringResource(R.string.ram_alloc_single)
+    val ramAllocMulti = stringResource(R.string.ram_alloc_multi)
     val romRandOps = stringResource(R.string.rom_rand_ops)
     val romSeqWrite = stringResource(R.string.rom_seq_write)
     val romSeqRead = stringResource(R.string.rom_seq_read)
+    val romWalSync = stringResource(R.string.rom_wal_sync)
+    val mixedContention = stringResource(R.string.mixed_contention)
     val cpuCryptoSingle = stringResource(R.string.cpu_crypto_single)
     val cpuCryptoMulti = stringResource(R.string.cpu_crypto_multi)
+    val cpuCryptoParallelCtr = stringResource(R.string.cpu_crypto_parallel_ctr)
+    val cpuCryptoSweep = stringResource(R.string.cpu_crypto_sweep)
+    val cpuPubkeySingle = stringResource(R.string.cpu_pubkey_single)
+    val cpuPubkeyMulti = stringResource(R.string.cpu_pubkey_multi)
+    val cpuCompressSingle = stringResource(R.string.cpu_compress_single)
+    val cpuCompressMulti = stringResource(R.string.cpu_compress_multi)
+    val cpuIntegerSingle = stringResource(R.string.cpu_integer_single)
+    val cpuIntegerMulti = stringResource(R.string.cpu_integer_multi)
+    val cpuC2cLatency = stringResource(R.string.cpu_c2c_latency)
+    val cpuSyncContention = stringResource(R.string.cpu_sync_contention)
     val gpuVulkanComputeGemm = stringResource(R.string.vulkan_compute_gemm)
+    val gpuDispatchLatency = stringResource(R.string.gpu_dispatch_latency)
     val gpuRT = stringResource(R.string.gpu_rt)
     val aiLiteRT = stringResource(R.string.ai_litert)
+    val aiLiteRTThroughput = stringResource(R.string.ai_litert_throughput)
 
     val lifecycleOwner = LocalLifecycleOwner.current
     var onResumeTrigger by remember { mutableIntStateOf(0) }
@@ -631,21 +650,42 @@ fun BenchMainScreen() {
     val cpuSubBenchmarks = listOf(
         SubBenchmark(titleKey = cpuMathSingleString, scoreKey = "cpu_math_single"),
         SubBenchmark(titleKey = cpuMathMultiString, scoreKey = "cpu_math_multi"),
+        SubBenchmark(titleKey = cpuSgemm, scoreKey = "cpu_sgemm"),
         SubBenchmark(titleKey = cpuCryptoSingle, scoreKey = "cpu_crypto_single"),
         SubBenchmark(titleKey = cpuCryptoMulti, scoreKey = "cpu_crypto_multi"),
+        SubBenchmark(titleKey = cpuCryptoParallelCtr, scoreKey = "cpu_crypto_parallel_ctr"),
+        SubBenchmark(titleKey = cpuCryptoSweep, scoreKey = "cpu_crypto_sweep"),
+        SubBenchmark(titleKey = cpuPubkeySingle, scoreKey = "cpu_pubkey_single"),
+        SubBenchmark(titleKey = cpuPubkeyMulti, scoreKey = "cpu_pubkey_multi"),
+        SubBenchmark(titleKey = cpuCompressSingle, scoreKey = "cpu_compress_single"),
+        SubBenchmark(titleKey = cpuCompressMulti, scoreKey = "cpu_compress_multi"),
+        SubBenchmark(titleKey = cpuIntegerSingle, scoreKey = "cpu_integer_single"),
+        SubBenchmark(titleKey = cpuIntegerMulti, scoreKey = "cpu_integer_multi"),
+        SubBenchmark(titleKey = cpuC2cLatency, scoreKey = "cpu_c2c_latency"),
+        SubBenchmark(titleKey = cpuSyncContention, scoreKey = "cpu_sync_contention"),
     )
     val gpuSubBenchmarks = listOf(
         SubBenchmark(titleKey = gpuVulkanComputeGemm, scoreKey = "gpu_gemm"),
+        SubBenchmark(titleKey = gpuDispatchLatency, scoreKey = "gpu_dispatch_latency"),
         SubBenchmark(titleKey = gpuRT, scoreKey = "gpu_rt")
     )
     val memSubBenchmarks = listOf(
         SubBenchmark(titleKey = ramSeqWrite, scoreKey = "ram_seq_write"),
         SubBenchmark(titleKey = ramSeqRead, scoreKey = "ram_seq_read"),
+        SubBenchmark(titleKey = ramBandwidthSweep, scoreKey = "ram_bandwidth_sweep"),
+        SubBenchmark(titleKey = ramPageFault, scoreKey = "ram_page_fault"),
+        SubBenchmark(titleKey = ramAllocSingle, scoreKey = "ram_alloc_single"),
+        SubBenchmark(titleKey = ramAllocMulti, scoreKey = "ram_alloc_multi"),
         SubBenchmark(titleKey = romRandOps, scoreKey = "rom_rand_ops"),
         SubBenchmark(titleKey = romSeqWrite, scoreKey = "rom_seq_write"),
-        SubBenchmark(titleKey = romSeqRead, scoreKey = "rom_seq_read")
+        SubBenchmark(titleKey = romSeqRead, scoreKey = "rom_seq_read"),
+        SubBenchmark(titleKey = romWalSync, scoreKey = "rom_wal_sync"),
+        SubBenchmark(titleKey = mixedContention, scoreKey = "mixed_contention")
+    )
+    val aiSubBenchmarks = listOf(
+        SubBenchmark(titleKey = aiLiteRT, scoreKey = "ai_litert"),
+        SubBenchmark(titleKey = aiLiteRTThroughput, scoreKey = "ai_litert_throughput")
     )
-    val aiSubBenchmarks = listOf(SubBenchmark(titleKey = aiLiteRT, scoreKey = "ai_litert"))
 
     val viewModel: BenchViewModel = viewModel()
     val percentileRank by viewModel.percentileRank
@@ -3,12 +3,14 @@ package com.komarudude.materialbench.utils
 import android.content.Context
 import com.google.ai.edge.litert.Accelerator
 import com.google.ai.edge.litert.CompiledModel
+import com.google.ai.edge.litert.TensorBuffer
 import kotlin.math.exp
 
 /**
  * MobileNetV4 wrapper.
- * - input: RGB ByteArray length = 384*384*3 (NHWC)
+ * - input: RGB ByteArray length = 384*384*3 (NHWC), or an already normalized FloatArray of the same length
  * - output: ClassificationResult with top-K, logits and probs
+ * Tensor buffers are created once in initialize() and reused, so one instance must not run on two threads at once.
  */
 class MobileNetV4Classifier(
     private val context: Context,
@@ -19,12 +21,14 @@ class MobileNetV4Classifier(
     private val INPUT_HEIGHT = 384
     private val INPUT_WIDTH = 384
     private val INPUT_CHANNELS = 3
-    private val INPUT_SIZE = INPUT_HEIGHT * INPUT_WIDTH * INPUT_CHANNELS
+    val INPUT_SIZE = INPUT_HEIGHT * INPUT_WIDTH * INPUT_CHANNELS
 
     private val MEAN = floatArrayOf(0.485f, 0.456f, 0.406f)
     private val STD = floatArrayOf(0.229f, 0.224f, 0.225f)
 
     private var compiledModel: CompiledModel? = null
+    private var inputBuffers: List<TensorBuffer> = emptyList()
+    private var outputBuffers: List<TensorBuffer> = emptyList()
     private var labels: List<String> = emptyList()
 
     data class TopKEntry(val classId: Int, val className: String, val prob: Float)
@@ -46,14 +50,20 @@ class MobileNetV4Classifier(
                 context.assets,
                 modelFileName,
                 CompiledModel.Options(accelerator)
-            )
+            ).also { model ->
+                inputBuffers = model.createInputBuffers()
+                outputBuffers = model.createOutputBuffers()
+            }
         } catch (e: Exception) {
             e.printStackTrace()
-            compiledModel = null
+            close()
             labels = emptyList()
         }
     }
 
+    val isInitialized: Boolean
+        get() = compiledModel != null
+
     private fun preprocessImage(imagePixels: ByteArray): FloatArray {
         require(imagePixels.size == INPUT_SIZE) { "Invalid input size. Expected $INPUT_SIZE bytes (RGB)." }
 
@@ -111,41 +121,61 @@ class MobileNetV4Classifier(
      * topKCount default = 5.
      */
     fun runInference(imagePixels: ByteArray, topKCount: Int = 5): ClassificationResult {
-        val model = compiledModel ?: throw IllegalStateException("Model not initialized. Call initialize()")
         require(imagePixels.size == INPUT_SIZE) { "Invalid input size. Expected $INPUT_SIZE bytes (RGB)." }
+        return runInference(preprocessImage(imagePixels), topKCount)
+    }
 
-        val inputFloat = preprocessImage(imagePixels)
+    /**
+     * Run inference on an input that is already normalized with MEAN/STD (e.g. by the native preprocessor).
+     */
+    fun runInference(inputFloat: FloatArray, topKCount: Int = 5): ClassificationResult {
+        val model = compiledModel ?: throw IllegalStateException("Model not initialized. Call initialize()")
+        require(inputFloat.size == INPUT_SIZE) { "Invalid input size. Expected $INPUT_SIZE floats (RGB)." }
+
+        inputBuffers[0].writeFloat(inputFloat)
+        model.run(inputBuffers, outputBuffers)
+
+        val outputFloat = outputBuffers[0].readFloat()
+        val probs = softmax(outputFloat)
+
+        val topIdx = argmax(probs)
+        val confidence = probs.getOrElse(topIdx) { 0f }
+        val name = if (labels.size > topIdx) labels[topIdx] else "class_$topIdx"
+        val topKList = topK(probs, topKCount)
+
+        return ClassificationResult(
+            classId = topIdx,
+            confidence = confidence,
+            className = name,
+            topK = topKList,
+            logits = outputFloat,
+            probs = probs
+        )
+    }
 
-        val inputBuffers = model.createInputBuffers()
-        val outputBuffers = model.createOutputBuffers()
+    /**
+     * Throughput path: same inference, but the logits stay in the reused output tensor buffer instead of
+     * being copied into a new array per image (run() is synchronous, so the work is done when it returns).
+     * Read the class of the last run with [lastTop1].
+     */
+    fun runInferenceInPlace(inputFloat: FloatArray) {
+        val model = compiledModel ?: throw IllegalStateException("Model not initialized. Call initialize()")
+        require(inputFloat.size == INPUT_SIZE) { "Invalid input size. Expected $INPUT_SIZE floats (RGB)." }
 
-        try {
-            inputBuffers[0].writeFloat(inputFloat)
-            model.run(inputBuffers, outputBuffers)
-
-            val outputFloat = outputBuffers[0].readFloat()
-            val probs = softmax(outputFloat)
-
-            val topIdx = argmax(probs)
-            val confidence = probs.getOrElse(topIdx) { 0f }
-            val name = if (labels.size > topIdx) labels[topIdx] else "class_$topIdx"
-            val topKList = topK(probs, topKCount)
-
-            return ClassificationResult(
-                classId = topIdx,
-                confidence = confidence,
-                className = name,
-                topK = topKList,
-                logits = outputFloat,
-                probs = probs
-            )
-        } finally {
-            inputBuffers.forEach { it.close() }
-            outputBuffers.forEach { it.close() }
-        }
+        inputBuffers[0].writeFloat(inputFloat)
+        model.run(inputBuffers, outputBuffers)
     }
 
+    /**
+     * Top-1 class id of the last run (argmax of the logits equals argmax of softmax).
+     */
+    fun lastTop1(): Int = argmax(outputBuffers[0].readFloat())
+
     fun close() {
+        inputBuffers.forEach { it.close() }
+        outputBuffers.forEach { it.close() }
+        inputBuffers = emptyList()
+        outputBuffers = emptyList()
         compiledModel?.close()
         compiledModel = null
     }